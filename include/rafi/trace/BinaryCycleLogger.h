@@ -27,9 +27,18 @@ class BinaryCycleLoggerImpl;
 class BinaryCycleLogger final
 {
 public:
+    // Size of the buffer the logger allocates itself. Buffers given by Reset() should have this size as well.
+    static constexpr size_t DefaultBufferSize = 4096;
+
     BinaryCycleLogger(uint32_t cycle, const XLEN& xlen, uint64_t pc);
+
+    // Logger which writes to external buffers given by Reset().
+    BinaryCycleLogger();
     ~BinaryCycleLogger();
 
+    // Begins a new cycle in pBuffer. The logger can be reused for every cycle without allocation.
+    void Reset(void* pBuffer, size_t bufferSize, uint32_t cycle, const XLEN& xlen, uint64_t pc);
+
     void Add(const NodeIntReg32& value);
     void Add(const NodeIntReg64& value);
     void Add(const NodeFpReg& value);
@@ -38,6 +47,11 @@ public:
     void Add(const NodeTrapEvent& value);
     void Add(const NodeMemoryEvent& value);
 
+    // Records registers as a delta node against the previous cycle.
+    void AddDelta(const NodeIntReg32& value, const NodeIntReg32& previous);
+    void AddDelta(const NodeIntReg64& value, const NodeIntReg64& previous);
+    void AddDelta(const NodeFpReg& value, const NodeFpReg& previous);
+
     void Break();
 
     // Get pointer to raw data
@@ -27,6 +27,8 @@ const uint16_t NodeId_BA = 0x4142; // BASIC
 const uint16_t NodeId_BR = 0x5242; // BREAK
 const uint16_t NodeId_IN = 0x4e49; // INT
 const uint16_t NodeId_FP = 0x5046; // FP
+const uint16_t NodeId_ID = 0x4449; // INT DELTA
+const uint16_t NodeId_FD = 0x4446; // FP DELTA
 const uint16_t NodeId_IO = 0x4f49; // IO
 const uint16_t NodeId_OP = 0x504f; // OP
 const uint16_t NodeId_TR = 0x5254; // TRAP
@@ -78,6 +80,15 @@ struct NodeFpReg
     FpRegUnion regs[FpRegCount];
 };
 
+// Header of delta nodes (NodeId_ID and NodeId_FD), which hold only registers changed from the previous cycle.
+// Bit i of mask is set if register i is changed. Values of the changed registers follow in index order.
+// Each value is uint32_t for int registers of XLEN32 and uint64_t otherwise.
+struct NodeRegDelta
+{
+    uint32_t mask;
+    uint32_t reserved;
+};
+
 struct NodeIo
 {
     uint32_t hostIo;
@@ -141,4 +152,25 @@ struct Csr64Node
     uint64_t value;
 };
 
+// Header of compressed trace segment (.tbin). Uncompressed segment has no header and starts with a node.
+// Blocks follow the header. Each block is SegmentBlockHeader and data compressed by the codec.
+// A block whose compressedSize equals to originalSize is stored without compression.
+const char SegmentSignature[8] = "RAFITBZ";
+
+const uint32_t SegmentCodec_Lz = 1;
+
+struct SegmentHeader
+{
+    char signature[8];
+    uint32_t codec;
+    uint32_t blockSize;
+    uint64_t dataSize;
+};
+
+struct SegmentBlockHeader
+{
+    uint32_t compressedSize;
+    uint32_t originalSize;
+};
+
 }}
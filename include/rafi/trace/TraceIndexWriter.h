@@ -27,11 +27,27 @@ class TraceIndexWriterImpl;
 class TraceIndexWriter : public ITraceWriter
 {
 public:
-    TraceIndexWriter(const char* pathBase);
+    // Compressed segments are smaller but have to be decompressed whole before the first cycle is read.
+    TraceIndexWriter(const char* pathBase, bool compressionEnabled = false);
     virtual ~TraceIndexWriter();
 
     virtual void Write(void* buffer, int64_t size);
 
+    // Returns a buffer to serialize a cycle of at most maxSize bytes without copy. EndWrite() commits it.
+    void* BeginWrite(int64_t maxSize);
+    void EndWrite(int64_t size);
+
+    // Returns true if the cycle given by BeginWrite() is the first one of a segment (.tbin file).
+    bool IsSegmentStart() const;
+
+    // Waits until the writer thread has written all submitted segments, then flushes the index file.
+    // Called before fork() so that the child does not inherit half-written index lines.
+    void Flush();
+
+    // Called in a child created by fork() to close the inherited index file.
+    // The writer thread does not exist in the child, so the object cannot be used or deleted after this.
+    void CloseInForkedProcess();
+
 private:
     TraceIndexWriterImpl* m_pImpl;
 };
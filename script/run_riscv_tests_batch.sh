@@ -0,0 +1,25 @@
+#!/bin/bash
+
+build_type="Release"
+if [ $# -ne 0 ]; then
+    build_type=$1
+    shift
+fi
+
+# Move to project top directory
+pushd `dirname $0`
+cd ..
+
+source script/common.sh.inc
+
+if [[ "$(uname)" =~ ^MINGW ]]; then
+    ./build_${build_type}/${build_type}/rafi-batch -i ./test/riscv_tests.config.json $@
+else
+    ./build_${build_type}/rafi-batch -i ./test/riscv_tests.config.json $@
+fi
+
+exit_code=$?
+
+popd
+
+exit ${exit_code}
@@ -21,7 +21,7 @@
 
 namespace rafi { namespace trace {
 
-std::unique_ptr<BinaryCycle> BinaryCycle::Parse(const void* buffer, size_t bufferSize)
+std::unique_ptr<BinaryCycle> BinaryCycle::Parse(const void* buffer, size_t bufferSize, const BinaryCycle* pPrevious)
 {
     auto p = std::make_unique<BinaryCycle>();
 
@@ -30,7 +30,7 @@ std::unique_ptr<BinaryCycle> BinaryCycle::Parse(const void* buffer, size_t buffe
 
     while (!p->m_Break)
     {
-        p->m_Size += p->ParseNode(reinterpret_cast<const uint8_t*>(buffer) + p->m_Size, bufferSize - p->m_Size);
+        p->m_Size += p->ParseNode(reinterpret_cast<const uint8_t*>(buffer) + p->m_Size, bufferSize - p->m_Size, pPrevious);
     }
 
     return p;
@@ -135,7 +135,7 @@ size_t BinaryCycle::GetSize() const
     return m_Size;
 }
 
-size_t BinaryCycle::ParseNode(const void* buffer, size_t bufferSize)
+size_t BinaryCycle::ParseNode(const void* buffer, size_t bufferSize, const BinaryCycle* pPrevious)
 {
     if (bufferSize < sizeof(NodeHeader))
     {
@@ -161,6 +161,12 @@ size_t BinaryCycle::ParseNode(const void* buffer, size_t bufferSize)
     case NodeId_FP:
         m_pNodeFpReg = reinterpret_cast<const NodeFpReg*>(&pHeader[1]);
         break;
+    case NodeId_FD:
+        ParseFpRegDelta(pHeader, pPrevious);
+        break;
+    case NodeId_ID:
+        ParseIntRegDelta(pHeader, pPrevious);
+        break;
     case NodeId_IN:
         if (!m_pNodeBasic)
         {
@@ -198,4 +204,85 @@ size_t BinaryCycle::ParseNode(const void* buffer, size_t bufferSize)
     return size;
 }
 
+void BinaryCycle::ParseIntRegDelta(const NodeHeader* pHeader, const BinaryCycle* pPrevious)
+{
+    if (!m_pNodeBasic)
+    {
+        throw TraceException("Detect IntReg node before Basic node\n");
+    }
+    if (pPrevious == nullptr || pPrevious->GetXLEN() != m_pNodeBasic->xlen || !pPrevious->IsIntRegExist())
+    {
+        throw TraceException("Detect IntReg delta node without IntReg of previous cycle\n");
+    }
+
+    if (m_pNodeBasic->xlen == XLEN::XLEN32)
+    {
+        m_IntReg32 = *pPrevious->m_pNodeIntReg32;
+        ApplyDelta(m_IntReg32.regs, IntRegCount, pHeader);
+        m_pNodeIntReg32 = &m_IntReg32;
+    }
+    else if (m_pNodeBasic->xlen == XLEN::XLEN64)
+    {
+        m_IntReg64 = *pPrevious->m_pNodeIntReg64;
+        ApplyDelta(m_IntReg64.regs, IntRegCount, pHeader);
+        m_pNodeIntReg64 = &m_IntReg64;
+    }
+    else
+    {
+        RAFI_NOT_IMPLEMENTED;
+    }
+}
+
+void BinaryCycle::ParseFpRegDelta(const NodeHeader* pHeader, const BinaryCycle* pPrevious)
+{
+    if (pPrevious == nullptr || !pPrevious->IsFpRegExist())
+    {
+        throw TraceException("Detect FpReg delta node without FpReg of previous cycle\n");
+    }
+
+    uint64_t values[FpRegCount];
+    for (int i = 0; i < FpRegCount; i++)
+    {
+        values[i] = pPrevious->GetFpReg(i);
+    }
+
+    ApplyDelta(values, FpRegCount, pHeader);
+
+    for (int i = 0; i < FpRegCount; i++)
+    {
+        m_FpReg.regs[i].u64.value = values[i];
+    }
+    m_pNodeFpReg = &m_FpReg;
+}
+
+template <typename T>
+void BinaryCycle::ApplyDelta(T* values, int count, const NodeHeader* pHeader)
+{
+    if (pHeader->nodeSize < sizeof(NodeRegDelta))
+    {
+        throw TraceException("Broken data @ BinaryCycle\n");
+    }
+
+    const auto pData = reinterpret_cast<const uint8_t*>(&pHeader[1]);
+
+    NodeRegDelta delta;
+    std::memcpy(&delta, pData, sizeof(delta));
+
+    size_t offset = sizeof(delta);
+
+    for (int i = 0; i < count; i++)
+    {
+        if (delta.mask & (1u << i))
+        {
+            if (offset + sizeof(T) > pHeader->nodeSize)
+            {
+                throw TraceException("Broken data @ BinaryCycle\n");
+            }
+
+            std::memcpy(&values[i], &pData[offset], sizeof(T));
+            offset += sizeof(T);
+        }
+    }
+}
+
 }}
@@ -26,7 +26,8 @@ namespace rafi { namespace trace {
 class BinaryCycle : public ICycle
 {
 public:
-    static std::unique_ptr<BinaryCycle> Parse(const void* buffer, size_t bufferSize);
+    // Delta nodes are applied to the registers of pPrevious.
+    static std::unique_ptr<BinaryCycle> Parse(const void* buffer, size_t bufferSize, const BinaryCycle* pPrevious);
 
     BinaryCycle();
     virtual ~BinaryCycle() override;
@@ -54,7 +55,12 @@ public:
     size_t GetSize() const;
 
 private:
-    size_t ParseNode(const void* buffer, size_t bufferSize);
+    size_t ParseNode(const void* buffer, size_t bufferSize, const BinaryCycle* pPrevious);
+    void ParseIntRegDelta(const NodeHeader* pHeader, const BinaryCycle* pPrevious);
+    void ParseFpRegDelta(const NodeHeader* pHeader, const BinaryCycle* pPrevious);
+
+    template <typename T>
+    void ApplyDelta(T* values, int count, const NodeHeader* pHeader);
 
     const void* m_pBuffer{ nullptr };
     size_t m_BufferSize{ 0 };
@@ -66,6 +72,11 @@ private:
     const NodeFpReg* m_pNodeFpReg{ nullptr };
     const NodeIo* m_pNodeIo{ nullptr };
 
+    // Registers reconstructed from delta nodes
+    NodeIntReg32 m_IntReg32;
+    NodeIntReg64 m_IntReg64;
+    NodeFpReg m_FpReg;
+
     std::vector<const NodeOpEvent*> m_OpEvents;
     std::vector<const NodeMemoryEvent*> m_MemoryEvents;
     std::vector<const NodeTrapEvent*> m_TrapEvents;
@@ -27,11 +27,21 @@ BinaryCycleLogger::BinaryCycleLogger(uint32_t cycle, const XLEN& xlen, uint64_t
     m_pImpl = new BinaryCycleLoggerImpl(cycle, xlen, pc);
 }
 
+BinaryCycleLogger::BinaryCycleLogger()
+{
+    m_pImpl = new BinaryCycleLoggerImpl();
+}
+
 BinaryCycleLogger::~BinaryCycleLogger()
 {
     delete m_pImpl;
 }
 
+void BinaryCycleLogger::Reset(void* pBuffer, size_t bufferSize, uint32_t cycle, const XLEN& xlen, uint64_t pc)
+{
+    m_pImpl->Reset(pBuffer, bufferSize, cycle, xlen, pc);
+}
+
 void BinaryCycleLogger::Add(const NodeIntReg32& value)
 {
     m_pImpl->Add(value);
@@ -67,6 +77,21 @@ void BinaryCycleLogger::Add(const NodeMemoryEvent& value)
     m_pImpl->Add(value);
 }
 
+void BinaryCycleLogger::AddDelta(const NodeIntReg32& value, const NodeIntReg32& previous)
+{
+    m_pImpl->AddDelta(value, previous);
+}
+
+void BinaryCycleLogger::AddDelta(const NodeIntReg64& value, const NodeIntReg64& previous)
+{
+    m_pImpl->AddDelta(value, previous);
+}
+
+void BinaryCycleLogger::AddDelta(const NodeFpReg& value, const NodeFpReg& previous)
+{
+    m_pImpl->AddDelta(value, previous);
+}
+
 void BinaryCycleLogger::Break()
 {
     m_pImpl->Break();
@@ -22,22 +22,42 @@
 
 namespace rafi { namespace trace {
 
-namespace {
-    size_t DefaultBufferSize = 4096;
-}
-
 BinaryCycleLoggerImpl::BinaryCycleLoggerImpl(uint32_t cycle, const XLEN& xlen, uint64_t pc)
 {
-    m_pBuffer = malloc(DefaultBufferSize);
-    m_BufferSize = DefaultBufferSize;
+    m_pBuffer = malloc(BinaryCycleLogger::DefaultBufferSize);
+    m_BufferSize = BinaryCycleLogger::DefaultBufferSize;
+    m_OwnsBuffer = true;
 
     NodeBasic node{ cycle, xlen, pc };
     Add(node);
 }
 
+BinaryCycleLoggerImpl::BinaryCycleLoggerImpl()
+{
+}
+
 BinaryCycleLoggerImpl::~BinaryCycleLoggerImpl()
 {
-    free(m_pBuffer);
+    if (m_OwnsBuffer)
+    {
+        free(m_pBuffer);
+    }
+}
+
+void BinaryCycleLoggerImpl::Reset(void* pBuffer, size_t bufferSize, uint32_t cycle, const XLEN& xlen, uint64_t pc)
+{
+    if (m_OwnsBuffer)
+    {
+        free(m_pBuffer);
+        m_OwnsBuffer = false;
+    }
+
+    m_pBuffer = pBuffer;
+    m_BufferSize = bufferSize;
+    m_DataSize = 0;
+
+    NodeBasic node{ cycle, xlen, pc };
+    Add(node);
 }
 
 void BinaryCycleLoggerImpl::Add(const NodeIntReg32& node)
@@ -75,6 +95,30 @@ void BinaryCycleLoggerImpl::Add(const NodeMemoryEvent& node)
     AddData(NodeId_MA, &node, sizeof(node));
 }
 
+void BinaryCycleLoggerImpl::AddDelta(const NodeIntReg32& node, const NodeIntReg32& previous)
+{
+    AddDeltaData(NodeId_ID, node.regs, previous.regs, IntRegCount);
+}
+
+void BinaryCycleLoggerImpl::AddDelta(const NodeIntReg64& node, const NodeIntReg64& previous)
+{
+    AddDeltaData(NodeId_ID, node.regs, previous.regs, IntRegCount);
+}
+
+void BinaryCycleLoggerImpl::AddDelta(const NodeFpReg& node, const NodeFpReg& previous)
+{
+    uint64_t values[FpRegCount];
+    uint64_t previousValues[FpRegCount];
+
+    for (int i = 0; i < FpRegCount; i++)
+    {
+        values[i] = node.regs[i].u64.value;
+        previousValues[i] = previous.regs[i].u64.value;
+    }
+
+    AddDeltaData(NodeId_FD, values, previousValues, FpRegCount);
+}
+
 void BinaryCycleLoggerImpl::Break()
 {
     AddData(NodeId_BR, nullptr, 0);
@@ -119,4 +163,30 @@ void BinaryCycleLoggerImpl::AddData(uint16_t nodeId, const void* pNode, size_t n
     }
 }
 
+template <typename T>
+void BinaryCycleLoggerImpl::AddDeltaData(uint16_t nodeId, const T* values, const T* previousValues, int count)
+{
+    static_assert(IntRegCount <= 32 && FpRegCount <= 32, "NodeRegDelta::mask is too small.");
+
+    uint8_t data[sizeof(NodeRegDelta) + sizeof(T) * 32];
+
+    NodeRegDelta delta{ 0, 0 };
+    size_t size = sizeof(delta);
+
+    for (int i = 0; i < count; i++)
+    {
+        if (values[i] != previousValues[i])
+        {
+            delta.mask |= 1u << i;
+
+            std::memcpy(&data[size], &values[i], sizeof(T));
+            size += sizeof(T);
+        }
+    }
+
+    std::memcpy(data, &delta, sizeof(delta));
+
+    AddData(nodeId, data, size);
+}
+
 }}
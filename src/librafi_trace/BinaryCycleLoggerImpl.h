@@ -24,8 +24,11 @@ class BinaryCycleLoggerImpl final
 {
 public:
     BinaryCycleLoggerImpl(uint32_t cycle, const XLEN& xlen, uint64_t pc);
+    BinaryCycleLoggerImpl();
     ~BinaryCycleLoggerImpl();
 
+    void Reset(void* pBuffer, size_t bufferSize, uint32_t cycle, const XLEN& xlen, uint64_t pc);
+
     void Add(const NodeIntReg32& node);
     void Add(const NodeIntReg64& node);
     void Add(const NodeFpReg& node);
@@ -34,6 +37,10 @@ public:
     void Add(const NodeTrapEvent& node);
     void Add(const NodeMemoryEvent& node);
 
+    void AddDelta(const NodeIntReg32& node, const NodeIntReg32& previous);
+    void AddDelta(const NodeIntReg64& node, const NodeIntReg64& previous);
+    void AddDelta(const NodeFpReg& node, const NodeFpReg& previous);
+
     void Break();
 
     // Get pointer to raw data
@@ -46,9 +53,13 @@ private:
     void Add(const NodeBasic& node);
     void AddData(uint16_t nodeId, const void* pNode, size_t nodeSize);
 
+    template <typename T>
+    void AddDeltaData(uint16_t nodeId, const T* values, const T* previousValues, int count);
+
     void* m_pBuffer{ nullptr };
     size_t m_BufferSize{ 0 };
     size_t m_DataSize{ 0 };
+    bool m_OwnsBuffer{ false };
 };
 
 
@@ -0,0 +1,272 @@
+/*
+ * Copyright 2018 Akifumi Fujita
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cstring>
+
+#include <rafi/trace.h>
+
+#include "LzCodec.h"
+
+namespace rafi { namespace trace {
+
+namespace {
+    const size_t MinMatchLength = 4;
+    const size_t MaxOffset = 65535;
+
+    // The last bytes are always literals, which makes decompression simple.
+    const size_t LastLiteralLength = 5;
+    const size_t MinInputLength = 13;
+
+    uint32_t Read32(const uint8_t* p)
+    {
+        uint32_t value;
+        std::memcpy(&value, p, sizeof(value));
+        return value;
+    }
+
+    uint32_t Hash(uint32_t value, int bits)
+    {
+        return (value * 2654435761u) >> (32 - bits);
+    }
+
+    // Writes the part of a length which does not fit in 4 bits of token.
+    bool WriteLength(uint8_t** ppOut, const uint8_t* pOutEnd, size_t length)
+    {
+        for (; length >= 255; length -= 255)
+        {
+            if (*ppOut >= pOutEnd)
+            {
+                return false;
+            }
+            *(*ppOut)++ = 255;
+        }
+
+        if (*ppOut >= pOutEnd)
+        {
+            return false;
+        }
+        *(*ppOut)++ = static_cast<uint8_t>(length);
+
+        return true;
+    }
+
+    bool ReadLength(const uint8_t** ppIn, const uint8_t* pInEnd, size_t* pLength)
+    {
+        while (true)
+        {
+            if (*ppIn >= pInEnd)
+            {
+                return false;
+            }
+
+            const auto value = *(*ppIn)++;
+            *pLength += value;
+
+            if (value != 255)
+            {
+                return true;
+            }
+        }
+    }
+
+    // Writes a sequence. Match is omitted if matchLength is zero (the last sequence).
+    bool WriteSequence(uint8_t** ppOut, const uint8_t* pOutEnd, const uint8_t* pLiteral, size_t literalLength, size_t offset, size_t matchLength)
+    {
+        const size_t matchCode = matchLength > 0 ? matchLength - MinMatchLength : 0;
+
+        if (*ppOut >= pOutEnd)
+        {
+            return false;
+        }
+
+        auto pToken = (*ppOut)++;
+        *pToken = static_cast<uint8_t>(((literalLength < 15 ? literalLength : 15) << 4) | (matchCode < 15 ? matchCode : 15));
+
+        if (literalLength >= 15 && !WriteLength(ppOut, pOutEnd, literalLength - 15))
+        {
+            return false;
+        }
+
+        if (static_cast<size_t>(pOutEnd - *ppOut) < literalLength)
+        {
+            return false;
+        }
+        std::memcpy(*ppOut, pLiteral, literalLength);
+        *ppOut += literalLength;
+
+        if (matchLength == 0)
+        {
+            return true;
+        }
+
+        if (pOutEnd - *ppOut < 2)
+        {
+            return false;
+        }
+        *(*ppOut)++ = static_cast<uint8_t>(offset);
+        *(*ppOut)++ = static_cast<uint8_t>(offset >> 8);
+
+        return matchCode < 15 || WriteLength(ppOut, pOutEnd, matchCode - 15);
+    }
+}
+
+size_t LzCompressor::Compress(void* pOut, size_t outSize, const void* pIn, size_t inSize)
+{
+    const auto pInBegin = reinterpret_cast<const uint8_t*>(pIn);
+    const auto pInEnd = pInBegin + inSize;
+    const auto pOutBegin = reinterpret_cast<uint8_t*>(pOut);
+    const auto pOutEnd = pOutBegin + outSize;
+
+    auto pDst = pOutBegin;
+    auto pSrc = pInBegin;
+    auto pAnchor = pInBegin;
+
+    if (inSize >= MinInputLength)
+    {
+        std::memset(m_HashTable, 0, sizeof(m_HashTable));
+
+        const auto pMatchLimit = pInEnd - LastLiteralLength;
+        const auto pSearchLimit = pMatchLimit - MinMatchLength;
+
+        while (pSrc < pSearchLimit)
+        {
+            const auto value = Read32(pSrc);
+            const auto hash = Hash(value, HashBits);
+            const auto candidate = m_HashTable[hash];
+
+            m_HashTable[hash] = static_cast<uint32_t>(pSrc - pInBegin + 1);
+
+            if (candidate == 0)
+            {
+                pSrc++;
+                continue;
+            }
+
+            const auto pMatch = pInBegin + candidate - 1;
+
+            if (static_cast<size_t>(pSrc - pMatch) > MaxOffset || Read32(pMatch) != value)
+            {
+                pSrc++;
+                continue;
+            }
+
+            size_t matchLength = MinMatchLength;
+            while (pSrc + matchLength < pMatchLimit && pMatch[matchLength] == pSrc[matchLength])
+            {
+                matchLength++;
+            }
+
+            if (!WriteSequence(&pDst, pOutEnd, pAnchor, pSrc - pAnchor, pSrc - pMatch, matchLength))
+            {
+                return 0;
+            }
+
+            pSrc += matchLength;
+            pAnchor = pSrc;
+        }
+    }
+
+    if (!WriteSequence(&pDst, pOutEnd, pAnchor, pInEnd - pAnchor, 0, 0))
+    {
+        return 0;
+    }
+
+    return pDst - pOutBegin;
+}
+
+void LzDecompress(void* pOut, size_t outSize, const void* pIn, size_t inSize)
+{
+    const auto pInEnd = reinterpret_cast<const uint8_t*>(pIn) + inSize;
+    const auto pOutBegin = reinterpret_cast<uint8_t*>(pOut);
+    const auto pOutEnd = pOutBegin + outSize;
+
+    auto pSrc = reinterpret_cast<const uint8_t*>(pIn);
+    auto pDst = pOutBegin;
+
+    while (true)
+    {
+        if (pSrc >= pInEnd)
+        {
+            throw TraceException("Broken compressed data. (Missing token)");
+        }
+
+        const auto token = *pSrc++;
+
+        size_t literalLength = token >> 4;
+        if (literalLength == 15 && !ReadLength(&pSrc, pInEnd, &literalLength))
+        {
+            throw TraceException("Broken compressed data. (Literal length)");
+        }
+
+        if (static_cast<size_t>(pInEnd - pSrc) < literalLength || static_cast<size_t>(pOutEnd - pDst) < literalLength)
+        {
+            throw TraceException("Broken compressed data. (Literal overflow)");
+        }
+
+        std::memcpy(pDst, pSrc, literalLength);
+        pSrc += literalLength;
+        pDst += literalLength;
+
+        // The last sequence has no match.
+        if (pSrc == pInEnd)
+        {
+            break;
+        }
+
+        if (pInEnd - pSrc < 2)
+        {
+            throw TraceException("Broken compressed data. (Offset)");
+        }
+
+        const size_t offset = pSrc[0] | (pSrc[1] << 8);
+        pSrc += 2;
+
+        size_t matchLength = token & 0xf;
+        if (matchLength == 15 && !ReadLength(&pSrc, pInEnd, &matchLength))
+        {
+            throw TraceException("Broken compressed data. (Match length)");
+        }
+        matchLength += MinMatchLength;
+
+        if (offset == 0 || static_cast<size_t>(pDst - pOutBegin) < offset || static_cast<size_t>(pOutEnd - pDst) < matchLength)
+        {
+            throw TraceException("Broken compressed data. (Match overflow)");
+        }
+
+        const auto pMatch = pDst - offset;
+
+        if (offset >= matchLength)
+        {
+            std::memcpy(pDst, pMatch, matchLength);
+        }
+        else
+        {
+            // Overlapped match repeats the last offset bytes.
+            for (size_t i = 0; i < matchLength; i++)
+            {
+                pDst[i] = pMatch[i];
+            }
+        }
+        pDst += matchLength;
+    }
+
+    if (pDst != pOutEnd)
+    {
+        throw TraceException("Broken compressed data. (Size mismatch)");
+    }
+}
+
+}}
@@ -0,0 +1,42 @@
+/*
+ * Copyright 2018 Akifumi Fujita
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace rafi { namespace trace {
+
+// LZ77 block codec for trace segments.
+// A block is a sequence of (literal length, literals, match offset, match length) in LZ4 style. Matches refer to at most 64 KiB before.
+class LzCompressor final
+{
+public:
+    // Returns the compressed size, or 0 if outSize is not enough.
+    size_t Compress(void* pOut, size_t outSize, const void* pIn, size_t inSize);
+
+private:
+    static const int HashBits = 16;
+
+    // Position + 1 of the last occurrence of 4 bytes for each hash (0 means none)
+    uint32_t m_HashTable[1 << HashBits];
+};
+
+// Throws TraceException if data is broken or does not fit in outSize exactly.
+void LzDecompress(void* pOut, size_t outSize, const void* pIn, size_t inSize);
+
+}}
@@ -29,7 +29,7 @@ TraceBinaryMemoryReaderImpl::TraceBinaryMemoryReaderImpl(const void* buffer, siz
 {
     CheckBufferSize();
 
-    m_pCycle = BinaryCycle::Parse(m_pBuffer, m_BufferSize);
+    m_pCycle = BinaryCycle::Parse(m_pBuffer, m_BufferSize, nullptr);
 }
 
 TraceBinaryMemoryReaderImpl::~TraceBinaryMemoryReaderImpl()
@@ -55,7 +55,7 @@ void TraceBinaryMemoryReaderImpl::Next()
 
     if (!IsEnd())
     {
-        m_pCycle = BinaryCycle::Parse(reinterpret_cast<const uint8_t*>(m_pBuffer) + m_Offset, m_BufferSize - m_Offset);
+        m_pCycle = BinaryCycle::Parse(reinterpret_cast<const uint8_t*>(m_pBuffer) + m_Offset, m_BufferSize - m_Offset, m_pCycle.get());
     }
     else
     {
@@ -22,9 +22,20 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+#ifdef WIN32
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
 
 #include <rafi/trace.h>
 
+#include "LzCodec.h"
 #include "TraceBinaryReaderImpl.h"
 
 namespace fs = std::experimental::filesystem;
@@ -53,24 +64,18 @@ TraceBinaryReaderImpl::TraceBinaryReaderImpl(const char* path)
 
     if (fileSize > 0)
     {
-        m_pBuffer = malloc(fileSize);
-        if (m_pBuffer == nullptr)
+        try
         {
-            throw TraceException("Failed to allocate memory.\n");
+            Load(path, static_cast<size_t>(fileSize));
+            Decompress();
         }
-        m_BufferSize = fileSize;
-
-        auto fp = std::fopen(path, "rb");
-
-        auto n = std::fread(m_pBuffer, m_BufferSize, 1, fp);
-        if (n != 1)
+        catch (...)
         {
-            throw TraceException("Failed to read file.\n");
+            Release();
+            throw;
         }
 
-        std::fclose(fp);
-
-        m_pImpl = new TraceBinaryMemoryReader(m_pBuffer, m_BufferSize);
+        m_pImpl = new TraceBinaryMemoryReader(m_pData, m_DataSize);
     }
 }
 
@@ -80,10 +85,8 @@ TraceBinaryReaderImpl::~TraceBinaryReaderImpl()
     {
         delete m_pImpl;
     }
-    if (m_pBuffer != nullptr)
-    {
-        free(m_pBuffer);
-    }
+
+    Release();
 }
 
 const ICycle* TraceBinaryReaderImpl::GetCycle() const
@@ -101,4 +104,157 @@ void TraceBinaryReaderImpl::Next()
     m_pImpl->Next();
 }
 
+// Maps the file so that pages are read on demand. Windows reads the whole file instead.
+void TraceBinaryReaderImpl::Load(const char* path, size_t fileSize)
+{
+#ifdef WIN32
+    m_pBuffer = malloc(fileSize);
+    if (m_pBuffer == nullptr)
+    {
+        throw TraceException("Failed to allocate memory.\n");
+    }
+
+    auto fp = std::fopen(path, "rb");
+    if (fp == nullptr)
+    {
+        throw FileOpenFailureException(path);
+    }
+
+    auto n = std::fread(m_pBuffer, fileSize, 1, fp);
+    std::fclose(fp);
+
+    if (n != 1)
+    {
+        throw TraceException("Failed to read file.\n");
+    }
+
+    m_pData = m_pBuffer;
+#else
+    const int fd = open(path, O_RDONLY);
+    if (fd < 0)
+    {
+        throw FileOpenFailureException(path);
+    }
+
+    void* p = mmap(nullptr, fileSize, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+
+    if (p == MAP_FAILED)
+    {
+        throw TraceException("Failed to map file.\n");
+    }
+
+    // Cycles are parsed from the beginning to the end.
+    madvise(p, fileSize, MADV_SEQUENTIAL);
+
+    m_pMappedData = p;
+    m_MappedSize = fileSize;
+    m_pData = m_pMappedData;
+#endif
+
+    m_DataSize = fileSize;
+}
+
+// Replaces the data with decompressed one if the file is a compressed segment.
+void TraceBinaryReaderImpl::Decompress()
+{
+    SegmentHeader header;
+
+    if (m_DataSize < sizeof(header) || std::memcmp(m_pData, SegmentSignature, sizeof(header.signature)) != 0)
+    {
+        return;
+    }
+
+    std::memcpy(&header, m_pData, sizeof(header));
+
+    if (header.codec != SegmentCodec_Lz)
+    {
+        throw TraceException("Unknown segment codec.");
+    }
+
+#if UINT64_MAX > SIZE_MAX
+    if (header.dataSize > SIZE_MAX)
+    {
+        throw TraceException("Segment is too large.");
+    }
+#endif
+
+    const auto dataSize = static_cast<size_t>(header.dataSize);
+
+    auto pData = reinterpret_cast<char*>(malloc(dataSize > 0 ? dataSize : 1));
+    if (pData == nullptr)
+    {
+        throw TraceException("Failed to allocate memory.\n");
+    }
+
+    try
+    {
+        const auto pSrcBegin = reinterpret_cast<const char*>(m_pData);
+        auto pSrc = pSrcBegin + sizeof(header);
+        size_t offset = 0;
+
+        while (offset < dataSize)
+        {
+            SegmentBlockHeader blockHeader;
+
+            if (m_DataSize - (pSrc - pSrcBegin) < sizeof(blockHeader))
+            {
+                throw TraceException("Broken segment. (Block header)");
+            }
+
+            std::memcpy(&blockHeader, pSrc, sizeof(blockHeader));
+            pSrc += sizeof(blockHeader);
+
+            if (blockHeader.originalSize == 0 || m_DataSize - (pSrc - pSrcBegin) < blockHeader.compressedSize || dataSize - offset < blockHeader.originalSize)
+            {
+                throw TraceException("Broken segment. (Block size)");
+            }
+
+            if (blockHeader.compressedSize == blockHeader.originalSize)
+            {
+                std::memcpy(&pData[offset], pSrc, blockHeader.originalSize);
+            }
+            else
+            {
+                LzDecompress(&pData[offset], blockHeader.originalSize, pSrc, blockHeader.compressedSize);
+            }
+
+            pSrc += blockHeader.compressedSize;
+            offset += blockHeader.originalSize;
+        }
+    }
+    catch (...)
+    {
+        free(pData);
+        throw;
+    }
+
+    Release();
+
+    m_pBuffer = pData;
+    m_pData = m_pBuffer;
+    m_DataSize = dataSize;
+}
+
+void TraceBinaryReaderImpl::Release()
+{
+#ifndef WIN32
+    if (m_pMappedData != nullptr)
+    {
+        munmap(m_pMappedData, m_MappedSize);
+        m_pMappedData = nullptr;
+        m_MappedSize = 0;
+    }
+#endif
+
+    if (m_pBuffer != nullptr)
+    {
+        free(m_pBuffer);
+        m_pBuffer = nullptr;
+    }
+
+    m_pData = nullptr;
+    m_DataSize = 0;
+}
+
 }}
@@ -38,10 +38,20 @@ public:
     void Next();
 
 private:
+    void Load(const char* path, size_t fileSize);
+    void Decompress();
+    void Release();
+
+    // Data parsed by m_pImpl, which points to either the mapped file or m_pBuffer
+    const void* m_pData{ nullptr };
+    size_t m_DataSize{ 0 };
+
+    void* m_pMappedData{ nullptr };
+    size_t m_MappedSize{ 0 };
+
     void* m_pBuffer{ nullptr };
-    size_t m_BufferSize{ 0 };
 
-    TraceBinaryMemoryReader* m_pImpl;
+    TraceBinaryMemoryReader* m_pImpl{ nullptr };
 };
 
 }}
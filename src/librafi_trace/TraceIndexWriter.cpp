@@ -20,9 +20,9 @@
 
 namespace rafi { namespace trace {
 
-TraceIndexWriter::TraceIndexWriter(const char* pathBase)
+TraceIndexWriter::TraceIndexWriter(const char* pathBase, bool compressionEnabled)
 {
-    m_pImpl = new TraceIndexWriterImpl(pathBase);
+    m_pImpl = new TraceIndexWriterImpl(pathBase, compressionEnabled);
 }
 
 TraceIndexWriter::~TraceIndexWriter()
@@ -35,4 +35,29 @@ void TraceIndexWriter::Write(void* buffer, int64_t size)
     m_pImpl->Write(buffer, size);
 }
 
+void* TraceIndexWriter::BeginWrite(int64_t maxSize)
+{
+    return m_pImpl->BeginWrite(maxSize);
+}
+
+void TraceIndexWriter::EndWrite(int64_t size)
+{
+    m_pImpl->EndWrite(size);
+}
+
+bool TraceIndexWriter::IsSegmentStart() const
+{
+    return m_pImpl->IsSegmentStart();
+}
+
+void TraceIndexWriter::Flush()
+{
+    m_pImpl->Flush();
+}
+
+void TraceIndexWriter::CloseInForkedProcess()
+{
+    m_pImpl->CloseInForkedProcess();
+}
+
 }}
@@ -14,7 +14,9 @@
  * limitations under the License.
  */
 
+#include <algorithm>
 #include <cstdio>
+#include <cstdlib>
 #include <cstring>
 #include <sstream>
 
@@ -24,30 +26,137 @@
 
 namespace rafi { namespace trace {
 
-TraceIndexWriterImpl::TraceIndexWriterImpl(const char* pathBase)
+TraceIndexWriterImpl::TraceIndexWriterImpl(const char* pathBase, bool compressionEnabled)
     : m_PathBase(pathBase)
+    , m_CompressionEnabled(compressionEnabled)
 {
     const auto path = std::string(pathBase) + ".tidx";
 
-    m_pData = (char*)std::malloc(MaxFileSize);
-
     m_pIndexFile = std::fopen(path.c_str(), "w");
     if (m_pIndexFile == nullptr)
     {
         throw FileOpenFailureException(path.c_str());
     }
+
+    for (auto& buffer: m_Buffers)
+    {
+        buffer.pData = (char*)std::malloc(MaxFileSize);
+        buffer.size = 0;
+        buffer.cycleCount = 0;
+
+        m_FreeBuffers.push_back(&buffer);
+    }
+
+    m_pCurrentBuffer = m_FreeBuffers.front();
+    m_FreeBuffers.pop_front();
+
+    if (m_CompressionEnabled)
+    {
+        // Compressed block is never larger than the original because incompressible block is stored as is.
+        const auto blockCount = (MaxFileSize + CompressionBlockSize - 1) / CompressionBlockSize;
+
+        m_pCompressedData = (char*)std::malloc(sizeof(SegmentHeader) + blockCount * sizeof(SegmentBlockHeader) + MaxFileSize);
+    }
+
+    m_WriterThread = std::thread(&TraceIndexWriterImpl::ProcessWriterThread, this);
 }
 
 TraceIndexWriterImpl::~TraceIndexWriterImpl()
 {
-    FlushData();
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        if (m_pCurrentBuffer->size > 0)
+        {
+            m_FullBuffers.push_back(m_pCurrentBuffer);
+        }
+        m_Finished = true;
+    }
+    m_FullBufferCondition.notify_one();
+
+    m_WriterThread.join();
+
+    // Destructor cannot throw.
+    if (m_WriterException)
+    {
+        try
+        {
+            std::rethrow_exception(m_WriterException);
+        }
+        catch (const FileOpenFailureException& e)
+        {
+            e.PrintMessage();
+        }
+    }
+
+    std::fclose(m_pIndexFile);
+
+    for (auto& buffer: m_Buffers)
+    {
+        std::free(buffer.pData);
+    }
+
+    std::free(m_pCompressedData);
+}
+
+void TraceIndexWriterImpl::Write(void* buffer, int64_t size)
+{
+    std::memcpy(BeginWrite(size), buffer, CheckSize(size));
+    EndWrite(size);
+}
+
+void* TraceIndexWriterImpl::BeginWrite(int64_t maxSize)
+{
+    if (m_pCurrentBuffer->size + CheckSize(maxSize) > MaxFileSize)
+    {
+        SubmitBuffer();
+    }
+
+    return &m_pCurrentBuffer->pData[m_pCurrentBuffer->size];
+}
+
+void TraceIndexWriterImpl::EndWrite(int64_t size)
+{
+    m_pCurrentBuffer->size += CheckSize(size);
+    m_pCurrentBuffer->cycleCount++;
+}
+
+bool TraceIndexWriterImpl::IsSegmentStart() const
+{
+    return m_pCurrentBuffer->cycleCount == 0;
+}
+
+void TraceIndexWriterImpl::Flush()
+{
+    std::unique_lock<std::mutex> lock(m_Mutex);
+
+    // The writer thread notifies m_FreeBufferCondition each time it finishes a buffer.
+    m_FreeBufferCondition.wait(lock, [this]{ return (m_FullBuffers.empty() && !m_Writing) || m_WriterException; });
+
+    if (m_WriterException)
+    {
+        std::rethrow_exception(m_WriterException);
+    }
+
+    std::fflush(m_pIndexFile);
+}
 
+void TraceIndexWriterImpl::CloseInForkedProcess()
+{
     std::fclose(m_pIndexFile);
+    m_pIndexFile = nullptr;
 
-    std::free(m_pData);
+    for (auto& buffer: m_Buffers)
+    {
+        std::free(buffer.pData);
+        buffer.pData = nullptr;
+    }
+
+    std::free(m_pCompressedData);
+    m_pCompressedData = nullptr;
 }
 
-void TraceIndexWriterImpl::Write(void* buffer, int64_t bufferSize)
+size_t TraceIndexWriterImpl::CheckSize(int64_t size)
 {
 #if INT64_MAX > SIZE_MAX
     if (size > SIZE_MAX)
@@ -56,30 +165,77 @@ void TraceIndexWriterImpl::Write(void* buffer, int64_t bufferSize)
     }
 #endif
 
-    const auto size = static_cast<size_t>(bufferSize);
-
-    if (size > MaxFileSize)
+    if (static_cast<size_t>(size) > MaxFileSize)
     {
         throw TraceException("argument 'size' is larger than MaxFileSize.");
     }
 
-    if (m_DataSize + size > MaxFileSize)
+    return static_cast<size_t>(size);
+}
+
+// Passes the current buffer to the writer thread and waits for a free one.
+void TraceIndexWriterImpl::SubmitBuffer()
+{
+    std::unique_lock<std::mutex> lock(m_Mutex);
+
+    m_FullBuffers.push_back(m_pCurrentBuffer);
+    m_FullBufferCondition.notify_one();
+
+    m_FreeBufferCondition.wait(lock, [this]{ return !m_FreeBuffers.empty() || m_WriterException; });
+
+    if (m_WriterException)
     {
-        FlushData();
+        std::rethrow_exception(m_WriterException);
     }
 
-    std::memcpy(&m_pData[m_DataSize], buffer, size);
-    m_DataSize += size;
-    m_CycleCount++;
+    m_pCurrentBuffer = m_FreeBuffers.front();
+    m_FreeBuffers.pop_front();
 }
 
-void TraceIndexWriterImpl::FlushData()
+void TraceIndexWriterImpl::ProcessWriterThread()
 {
-    if (m_DataSize == 0)
+    std::unique_lock<std::mutex> lock(m_Mutex);
+
+    while (true)
     {
-        return;
+        m_FullBufferCondition.wait(lock, [this]{ return !m_FullBuffers.empty() || m_Finished; });
+
+        if (m_FullBuffers.empty())
+        {
+            return;
+        }
+
+        auto pBuffer = m_FullBuffers.front();
+        m_FullBuffers.pop_front();
+        m_Writing = true;
+
+        lock.unlock();
+
+        try
+        {
+            WriteDataFile(*pBuffer);
+        }
+        catch (...)
+        {
+            lock.lock();
+            m_Writing = false;
+            m_WriterException = std::current_exception();
+            m_FreeBufferCondition.notify_one();
+            return;
+        }
+
+        pBuffer->size = 0;
+        pBuffer->cycleCount = 0;
+
+        lock.lock();
+        m_Writing = false;
+        m_FreeBuffers.push_back(pBuffer);
+        m_FreeBufferCondition.notify_one();
     }
+}
 
+void TraceIndexWriterImpl::WriteDataFile(const Buffer& buffer)
+{
     // Generate data file path
     std::stringstream ss;
     ss << m_PathBase << "." << m_DataFileCount << ".tbin";
@@ -93,15 +249,63 @@ void TraceIndexWriterImpl::FlushData()
         throw FileOpenFailureException(path.c_str());
     }
 
-    std::fwrite(m_pData, m_DataSize, 1, fp);
+    if (m_CompressionEnabled)
+    {
+        const auto compressedSize = Compress(buffer);
+
+        std::fwrite(m_pCompressedData, compressedSize, 1, fp);
+    }
+    else
+    {
+        std::fwrite(buffer.pData, buffer.size, 1, fp);
+    }
     std::fclose(fp);
 
     // Write path to index file
-    std::fprintf(m_pIndexFile, "%s %d\n", path.c_str(), m_CycleCount);
+    std::fprintf(m_pIndexFile, "%s %d\n", path.c_str(), buffer.cycleCount);
 
-    m_DataSize = 0;
-    m_CycleCount = 0;
     m_DataFileCount++;
 }
 
+size_t TraceIndexWriterImpl::Compress(const Buffer& buffer)
+{
+    SegmentHeader header;
+
+    std::memcpy(header.signature, SegmentSignature, sizeof(header.signature));
+    header.codec = SegmentCodec_Lz;
+    header.blockSize = static_cast<uint32_t>(CompressionBlockSize);
+    header.dataSize = buffer.size;
+
+    std::memcpy(m_pCompressedData, &header, sizeof(header));
+
+    size_t compressedSize = sizeof(header);
+
+    for (size_t offset = 0; offset < buffer.size; offset += CompressionBlockSize)
+    {
+        const auto originalSize = std::min(buffer.size - offset, CompressionBlockSize);
+        const auto pBlock = &buffer.pData[offset];
+
+        auto pBlockHeader = &m_pCompressedData[compressedSize];
+        auto pBlockData = pBlockHeader + sizeof(SegmentBlockHeader);
+
+        // Compressed data must be smaller than the original to be distinguished from stored block.
+        auto size = m_Compressor.Compress(pBlockData, originalSize - 1, pBlock, originalSize);
+        if (size == 0)
+        {
+            std::memcpy(pBlockData, pBlock, originalSize);
+            size = originalSize;
+        }
+
+        SegmentBlockHeader blockHeader;
+        blockHeader.compressedSize = static_cast<uint32_t>(size);
+        blockHeader.originalSize = static_cast<uint32_t>(originalSize);
+
+        std::memcpy(pBlockHeader, &blockHeader, sizeof(blockHeader));
+
+        compressedSize += sizeof(SegmentBlockHeader) + size;
+    }
+
+    return compressedSize;
+}
+
 }}
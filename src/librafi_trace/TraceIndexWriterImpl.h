@@ -16,31 +16,81 @@
 
 #pragma once
 
+#include <condition_variable>
 #include <cstdio>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <string>
+#include <thread>
 
 #include <rafi/trace.h>
 
+#include "LzCodec.h"
+
 namespace rafi { namespace trace {
 
 class TraceIndexWriterImpl final
 {
 public:
-    explicit TraceIndexWriterImpl(const char* pathBase);
+    TraceIndexWriterImpl(const char* pathBase, bool compressionEnabled);
     ~TraceIndexWriterImpl();
 
     void Write(void* buffer, int64_t size);
 
+    void* BeginWrite(int64_t maxSize);
+    void EndWrite(int64_t size);
+
+    bool IsSegmentStart() const;
+
+    void Flush();
+    void CloseInForkedProcess();
+
 private:
-    static const size_t MaxFileSize = 256 * 1024 * 1024;
+    static constexpr size_t MaxFileSize = 256 * 1024 * 1024;
+    static constexpr size_t CompressionBlockSize = 1024 * 1024;
+
+    // A full buffer is written to file by the writer thread while the next one is filled.
+    static const int BufferCount = 2;
+
+    struct Buffer
+    {
+        char* pData;
+        size_t size;
+        int cycleCount;
+    };
 
-    void FlushData();
+    static size_t CheckSize(int64_t size);
+
+    void SubmitBuffer();
+
+    // Executed on the writer thread
+    void ProcessWriterThread();
+    void WriteDataFile(const Buffer& buffer);
+    size_t Compress(const Buffer& buffer);
 
     std::string m_PathBase;
+    bool m_CompressionEnabled;
     std::FILE* m_pIndexFile{ nullptr };
 
-    char* m_pData;
-    size_t m_DataSize{ 0 };
-    int m_CycleCount{ 0 };
+    Buffer m_Buffers[BufferCount];
+    Buffer* m_pCurrentBuffer{ nullptr };
+
+    std::mutex m_Mutex;
+    std::condition_variable m_FreeBufferCondition;
+    std::condition_variable m_FullBufferCondition;
+    std::deque<Buffer*> m_FreeBuffers;
+    std::deque<Buffer*> m_FullBuffers;
+    std::exception_ptr m_WriterException;
+    bool m_Writing{ false };
+    bool m_Finished{ false };
+
+    std::thread m_WriterThread;
+
+    // Used only by the writer thread if compression is enabled
+    LzCompressor m_Compressor;
+    char* m_pCompressedData{ nullptr };
+
     int m_DataFileCount{ 0 };
 };
 
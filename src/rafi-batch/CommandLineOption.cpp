@@ -0,0 +1,106 @@
+/*
+ * Copyright 2018 Akifumi Fujita
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+
+#include <boost/program_options.hpp>
+
+#include <rafi/common.h>
+
+#include "CommandLineOption.h"
+
+namespace po = boost::program_options;
+
+namespace rafi { namespace batch {
+
+namespace {
+    static const char* DefaultBinaryDirPath = "./third_party/rafi-prebuilt-binary/riscv-tests/isa";
+}
+
+CommandLineOption::CommandLineOption(int argc, char** argv)
+{
+    po::options_description desc("options");
+    desc.add_options()
+        ("input,i", po::value<std::string>(&m_InputPath)->required(), "test list json path")
+        ("binary-dir,b", po::value<std::string>(&m_BinaryDirPath)->default_value(DefaultBinaryDirPath), "directory of test binaries (<name>.bin)")
+        ("filter,f", po::value<std::string>(&m_Filter)->default_value("*"), "filter tests by name (wildcard)")
+        ("jobs,j", po::value<int>(&m_ThreadCount)->default_value(0), "number of threads (0 means the number of hardware threads)")
+        ("enable-basic-block", "execute ops by basic block")
+        ("enable-jit", "compile hot integer ops to host code (x86-64 only, implies --enable-basic-block)")
+        ("help,h", "show help");
+
+    po::variables_map variables;
+    try
+    {
+        po::store(po::parse_command_line(argc, argv, desc), variables);
+
+        if (variables.count("help"))
+        {
+            std::cout << desc << std::endl;
+            std::exit(0);
+        }
+
+        po::notify(variables);
+    }
+    catch (const boost::program_options::error& e)
+    {
+        std::cout << e.what() << std::endl;
+        std::exit(1);
+    }
+
+    m_BasicBlockEnabled = variables.count("enable-basic-block") > 0;
+    m_JitEnabled = variables.count("enable-jit") > 0;
+
+    if (m_ThreadCount <= 0)
+    {
+        m_ThreadCount = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    }
+}
+
+const std::string& CommandLineOption::GetInputPath() const
+{
+    return m_InputPath;
+}
+
+const std::string& CommandLineOption::GetBinaryDirPath() const
+{
+    return m_BinaryDirPath;
+}
+
+const std::string& CommandLineOption::GetFilter() const
+{
+    return m_Filter;
+}
+
+int CommandLineOption::GetThreadCount() const
+{
+    return m_ThreadCount;
+}
+
+bool CommandLineOption::IsBasicBlockEnabled() const
+{
+    return m_BasicBlockEnabled;
+}
+
+bool CommandLineOption::IsJitEnabled() const
+{
+    return m_JitEnabled;
+}
+
+}}
@@ -0,0 +1,48 @@
+/*
+ * Copyright 2018 Akifumi Fujita
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <string>
+
+namespace rafi { namespace batch {
+
+class CommandLineOption
+{
+public:
+    CommandLineOption(int argc, char** argv);
+
+    const std::string& GetInputPath() const;
+    const std::string& GetBinaryDirPath() const;
+    const std::string& GetFilter() const;
+
+    int GetThreadCount() const;
+
+    bool IsBasicBlockEnabled() const;
+    bool IsJitEnabled() const;
+
+private:
+    std::string m_InputPath;
+    std::string m_BinaryDirPath;
+    std::string m_Filter;
+
+    int m_ThreadCount{ 0 };
+
+    bool m_BasicBlockEnabled{ false };
+    bool m_JitEnabled{ false };
+};
+
+}}
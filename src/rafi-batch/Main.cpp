@@ -0,0 +1,153 @@
+/*
+ * Copyright 2018 Akifumi Fujita
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#include <rafi/common.h>
+
+#include "../rafi-emu/Farm.h"
+
+#include "CommandLineOption.h"
+#include "TestConfig.h"
+
+namespace rafi { namespace batch {
+
+namespace {
+    const char* Pass = "[  PASS  ]";
+    const char* Failed = "[ FAILED ]";
+    uint32_t ExpectedHostIoValue = 1;
+
+    const paddr_t EntryAddress = 0x80000000;
+    const size_t RamSize = 64 * 1024 * 1024;
+}
+
+// Host io value is checked in memory instead of dumping trace.
+emu::FarmJob MakeFarmJob(const CommandLineOption& option, const TestConfig& config)
+{
+    emu::FarmJob job;
+
+    job.xlen = config.xlen;
+    job.pc = EntryAddress;
+    job.ramSize = RamSize;
+    job.images.push_back({ option.GetBinaryDirPath() + "/" + config.name + ".bin", EntryAddress });
+    job.condition = emu::EmulationStop_HostIo;
+    job.hostIoAddress = config.hostIoAddress;
+    job.cycle = config.cycle;
+    job.basicBlockEnabled = option.IsBasicBlockEnabled();
+    job.jitEnabled = option.IsJitEnabled();
+
+    return job;
+}
+
+bool PrintResult(const TestConfig& config, const emu::FarmResult& result)
+{
+    if (!result.completed)
+    {
+        std::cout << Failed << " " << config.name << " (stopped by exception)" << std::endl;
+        return false;
+    }
+
+    if (result.hostIoValue != ExpectedHostIoValue)
+    {
+        std::cout << Failed << " " << config.name << " ("
+            << std::hex << "hostIoValue:0x" << result.hostIoValue << " "
+            << std::dec << "testId:" << (result.hostIoValue / 2) << " "
+            << "cycle:" << result.cycle
+            << ")" << std::endl;
+        return false;
+    }
+
+    std::cout << Pass << " " << config.name << std::endl;
+    return true;
+}
+
+int Run(const CommandLineOption& option)
+{
+    std::vector<TestConfig> runnable;
+    std::vector<emu::FarmJob> jobs;
+    std::vector<TestConfig> skipped;
+
+    for (const auto& config: LoadTestConfigs(option.GetInputPath().c_str()))
+    {
+        if (!MatchWildcard(option.GetFilter().c_str(), config.name.c_str()))
+        {
+            continue;
+        }
+
+        if (config.skip)
+        {
+            skipped.push_back(config);
+        }
+        else
+        {
+            runnable.push_back(config);
+            jobs.push_back(MakeFarmJob(option, config));
+        }
+    }
+
+    emu::Farm farm(option.GetThreadCount());
+    const auto results = farm.Run(jobs);
+
+    int passCount = 0;
+    int failCount = 0;
+
+    for (size_t i = 0; i < runnable.size(); i++)
+    {
+        if (PrintResult(runnable[i], results[i]))
+        {
+            passCount++;
+        }
+        else
+        {
+            failCount++;
+        }
+    }
+
+    const int testCount = passCount + failCount;
+
+    std::cout << std::endl;
+    std::cout << testCount << " tests executed (" << passCount << " passed, " << failCount << " failed)." << std::endl;
+
+    if (skipped.size() > 0)
+    {
+        std::cout << "Skipped tests:" << std::endl;
+        for (const auto& config: skipped)
+        {
+            std::cout << "    " << config.name << std::endl;
+        }
+    }
+
+    return failCount;
+}
+
+}}
+
+int main(int argc, char** argv)
+{
+    rafi::batch::CommandLineOption option(argc, argv);
+
+    try
+    {
+        return rafi::batch::Run(option);
+    }
+    catch (const rafi::FileOpenFailureException& e)
+    {
+        e.PrintMessage();
+        return 1;
+    }
+}
@@ -0,0 +1,77 @@
+/*
+ * Copyright 2018 Akifumi Fujita
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cstdlib>
+#include <iostream>
+
+#include <boost/property_tree/json_parser.hpp>
+#include <boost/property_tree/ptree.hpp>
+
+#include "TestConfig.h"
+
+namespace pt = boost::property_tree;
+
+namespace rafi { namespace batch {
+
+std::vector<TestConfig> LoadTestConfigs(const char* path)
+{
+    std::vector<TestConfig> configs;
+
+    try
+    {
+        pt::ptree root;
+        pt::read_json(path, root);
+
+        // Elements of json array have empty keys.
+        for (const auto& child: root)
+        {
+            const auto& entry = child.second;
+
+            TestConfig config;
+            config.name = entry.get<std::string>("name");
+            config.hostIoAddress = std::strtoull(entry.get<std::string>("host-io-addr").c_str(), 0, 16);
+            config.xlen = entry.get<int>("xlen") == 64 ? XLEN::XLEN64 : XLEN::XLEN32;
+            config.cycle = entry.get<int>("cycle");
+            config.skip = entry.get<bool>("skip", false);
+
+            configs.push_back(config);
+        }
+    }
+    catch (const pt::ptree_error& e)
+    {
+        std::cout << e.what() << std::endl;
+        throw FileOpenFailureException(path, "(failed to parse test list)");
+    }
+
+    return configs;
+}
+
+bool MatchWildcard(const char* pattern, const char* name)
+{
+    switch (*pattern)
+    {
+    case '\0':
+        return *name == '\0';
+    case '*':
+        return MatchWildcard(pattern + 1, name) || (*name != '\0' && MatchWildcard(pattern, name + 1));
+    case '?':
+        return *name != '\0' && MatchWildcard(pattern + 1, name + 1);
+    default:
+        return *pattern == *name && MatchWildcard(pattern + 1, name + 1);
+    }
+}
+
+}}
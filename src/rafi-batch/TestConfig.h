@@ -0,0 +1,41 @@
+/*
+ * Copyright 2018 Akifumi Fujita
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <rafi/common.h>
+
+namespace rafi { namespace batch {
+
+// An entry of test list json (test/riscv_tests.config.json)
+struct TestConfig
+{
+    std::string name;
+    uint64_t hostIoAddress;
+    XLEN xlen;
+    int cycle;
+    bool skip;
+};
+
+std::vector<TestConfig> LoadTestConfigs(const char* path);
+
+// Matches name with a pattern which may contain '*' and '?'.
+bool MatchWildcard(const char* pattern, const char* name);
+
+}}
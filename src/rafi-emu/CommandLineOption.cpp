@@ -16,10 +16,12 @@
 
 #include <cstdlib>
 #include <iostream>
+#include <limits>
 
 #include <boost/program_options.hpp>
 
 #include <rafi/common.h>
+#include <rafi/emu.h>
 
 #include "CommandLineOption.h"
 
@@ -100,19 +102,31 @@ CommandLineOption::CommandLineOption(int argc, char** argv)
 {
     po::options_description desc("options");
     desc.add_options()
+        ("checkpoint-interval", po::value<int>(&m_CheckpointInterval)->default_value(0), "interval of checkpoints (cycle)")
+        ("checkpoint-path", po::value<std::string>(&m_CheckpointPath), "path of checkpoint files (the first one is full and the rest are incremental snapshots)")
         ("cycle", po::value<int>(&m_Cycle)->default_value(0), "number of emulation cycles")
         ("dump-path", po::value<std::string>(), "path of dump file")
         ("dump-skip-cycle", po::value<int>(&m_DumpSkipCycle)->default_value(0), "number of cycles to skip dump")
+        ("enable-basic-block", "execute ops by basic block")
+        ("enable-dump-compression", "compress dump files (they have to be decompressed whole to be read)")
         ("enable-dump-csr", "output csr contents to dump file")
         ("enable-dump-fp-reg", "output fp register contents to dump file")
         ("enable-dump-memory", "output memory contents to dump file")
+        ("enable-file-mapping", "map files of --load to ram copy-on-write instead of reading them (POSIX only)")
+        ("enable-idle-skip", "skip cycles until the next timer interrupt on wfi")
+        ("enable-jit", "compile hot integer ops to host code (x86-64 only, implies --enable-basic-block)")
+        ("fork-cycle", po::value<int>(&m_ForkCycle)->default_value(0), "cycle to fork emulation for each --fork-load (POSIX only)")
+        ("fork-load", po::value<std::vector<std::string>>(), "path of binary file which is loaded to memory of a forked emulation")
         ("gdb", po::value<int>(&m_GdbPort), "enable gdb and specify tcp port")
         ("load", po::value<std::vector<std::string>>(), "path of binary file which is loaded to memory")
+        ("load-elf", po::value<std::string>(&m_LoadElfPath), "path of ELF file whose segments are loaded to memory (entry point and tohost are used unless --pc and --host-io-addr are specified)")
+        ("load-snapshot", po::value<std::vector<std::string>>(&m_LoadSnapshotPaths), "path of snapshot file which is loaded before emulation (incremental ones follow their previous ones)")
         ("help", "show help")
         ("host-io-addr", po::value<std::string>(), "host io address (hex)")
         ("dtb-addr", po::value<std::string>(), "dtb address (hex)")
         ("pc", po::value<std::string>(), "initial program counter value (hex)")
         ("ram-size", po::value<size_t>(&m_RamSize)->default_value(DefaultRamSize), "ram size (byte)")
+        ("save-snapshot", po::value<std::string>(), "save snapshot at the specified cycle (<path>@<cycle>)")
         ("xlen", po::value<int>(), "XLEN");
 
     po::variables_map variables;
@@ -133,8 +147,28 @@ CommandLineOption::CommandLineOption(int argc, char** argv)
         std::exit(0);
     }
 
+    m_BasicBlockEnabled = variables.count("enable-basic-block") > 0;
+    m_CheckpointEnabled = variables.count("checkpoint-path") > 0;
+    m_FileMappingEnabled = variables.count("enable-file-mapping") > 0;
+    m_ForkEnabled = variables.count("fork-load") > 0;
     m_GdbEnabled = variables.count("gdb") > 0;
     m_HostIoEnabled = variables.count("host-io-addr") > 0;
+    m_IdleSkipEnabled = variables.count("enable-idle-skip") > 0;
+    m_JitEnabled = variables.count("enable-jit") > 0;
+    m_LoadElfEnabled = variables.count("load-elf") > 0;
+    m_SaveSnapshotEnabled = variables.count("save-snapshot") > 0;
+
+    if (m_LoadElfEnabled)
+    {
+        try
+        {
+            ParseElf(!variables.count("xlen"), !variables.count("pc"), !variables.count("host-io-addr"));
+        }
+        catch (RafiEmuException)
+        {
+            std::exit(1);
+        }
+    }
 
     if (variables.count("dump-path"))
     {
@@ -145,6 +179,7 @@ CommandLineOption::CommandLineOption(int argc, char** argv)
         m_TraceLoggerConfig.enableDumpCsr = variables.count("enable-memory-csr") > 0;
         m_TraceLoggerConfig.enableDumpMemory = false;
         m_TraceLoggerConfig.enableDumpHostIo = m_HostIoEnabled;
+        m_TraceLoggerConfig.enableCompression = variables.count("enable-dump-compression") > 0;
         m_TraceLoggerConfig.path = variables["dump-path"].as<std::string>();
     }
     else
@@ -152,6 +187,12 @@ CommandLineOption::CommandLineOption(int argc, char** argv)
         m_TraceLoggerConfig.enabled = false;
     }
 
+    if (m_CheckpointEnabled && m_CheckpointInterval <= 0)
+    {
+        std::cout << "--checkpoint-interval must be positive." << std::endl;
+        std::exit(1);
+    }
+
     if (variables.count("dtb-addr"))
     {
         m_DtbAddress = strtoull(variables["dtb-addr"].as<std::string>().c_str(), 0, 16);
@@ -167,9 +208,23 @@ CommandLineOption::CommandLineOption(int argc, char** argv)
 
     try
     {
-        for (auto& str: variables["load"].as<std::vector<std::string>>())
+        if (variables.count("load"))
         {
-            m_LoadOptions.emplace_back(str);
+            for (auto& str: variables["load"].as<std::vector<std::string>>())
+            {
+                m_LoadOptions.emplace_back(str);
+            }
+        }
+        if (variables.count("fork-load"))
+        {
+            for (auto& str: variables["fork-load"].as<std::vector<std::string>>())
+            {
+                m_ForkLoadOptions.emplace_back(str);
+            }
+        }
+        if (variables.count("save-snapshot"))
+        {
+            ParseSaveSnapshot(variables["save-snapshot"].as<std::string>());
         }
     }
     catch (CommandLineOptionException e)
@@ -201,16 +256,66 @@ bool CommandLineOption::IsHostIoEnabled() const
     return m_HostIoEnabled;
 }
 
+bool CommandLineOption::IsIdleSkipEnabled() const
+{
+    return m_IdleSkipEnabled;
+}
+
+bool CommandLineOption::IsJitEnabled() const
+{
+    return m_JitEnabled;
+}
+
+bool CommandLineOption::IsLoadElfEnabled() const
+{
+    return m_LoadElfEnabled;
+}
+
+bool CommandLineOption::IsSaveSnapshotEnabled() const
+{
+    return m_SaveSnapshotEnabled;
+}
+
+bool CommandLineOption::IsBasicBlockEnabled() const
+{
+    return m_BasicBlockEnabled;
+}
+
+bool CommandLineOption::IsCheckpointEnabled() const
+{
+    return m_CheckpointEnabled;
+}
+
+bool CommandLineOption::IsFileMappingEnabled() const
+{
+    return m_FileMappingEnabled;
+}
+
+bool CommandLineOption::IsForkEnabled() const
+{
+    return m_ForkEnabled;
+}
+
 bool CommandLineOption::IsGdbEnabled() const
 {
     return m_GdbEnabled;
 }
 
+const ElfFile& CommandLineOption::GetElfFile() const
+{
+    return *m_pElfFile;
+}
+
 const TraceLoggerConfig& CommandLineOption::GetTraceLoggerConfig() const
 {
     return m_TraceLoggerConfig;
 }
 
+const std::vector<LoadOption>& CommandLineOption::GetForkLoadOptions() const
+{
+    return m_ForkLoadOptions;
+}
+
 const std::vector<LoadOption>& CommandLineOption::GetLoadOptions() const
 {
     return m_LoadOptions;
@@ -221,6 +326,26 @@ XLEN CommandLineOption::GetXLEN() const
     return m_XLEN;
 }
 
+const std::string& CommandLineOption::GetCheckpointPath() const
+{
+    return m_CheckpointPath;
+}
+
+const std::vector<std::string>& CommandLineOption::GetLoadSnapshotPaths() const
+{
+    return m_LoadSnapshotPaths;
+}
+
+const std::string& CommandLineOption::GetSaveSnapshotPath() const
+{
+    return m_SaveSnapshotPath;
+}
+
+int CommandLineOption::GetCheckpointInterval() const
+{
+    return m_CheckpointInterval;
+}
+
 int CommandLineOption::GetCycle() const
 {
     return m_Cycle;
@@ -231,11 +356,21 @@ int CommandLineOption::GetGdbPort() const
     return m_GdbPort;
 }
 
+int CommandLineOption::GetSaveSnapshotCycle() const
+{
+    return m_SaveSnapshotCycle;
+}
+
 int CommandLineOption::GetDumpSkipCycle() const
 {
     return m_DumpSkipCycle;
 }
 
+int CommandLineOption::GetForkCycle() const
+{
+    return m_ForkCycle;
+}
+
 size_t CommandLineOption::GetRamSize() const
 {
     return m_RamSize;
@@ -256,4 +391,45 @@ uint64_t CommandLineOption::GetPc() const
     return m_Pc;
 }
 
+// Takes options which are not specified explicitly from ELF header and symbols.
+void CommandLineOption::ParseElf(bool useXLEN, bool usePc, bool useHostIoAddress)
+{
+    m_pElfFile = std::make_unique<ElfFile>(m_LoadElfPath.c_str());
+
+    if (useXLEN)
+    {
+        m_XLEN = m_pElfFile->GetXLEN();
+    }
+    if (usePc)
+    {
+        m_Pc = m_pElfFile->GetEntry();
+    }
+    if (useHostIoAddress)
+    {
+        m_HostIoEnabled = m_pElfFile->FindSymbol(&m_HostIoAddress, "tohost");
+    }
+}
+
+void CommandLineOption::ParseSaveSnapshot(const std::string& arg)
+{
+    const auto delimPos = arg.rfind('@');
+
+    if (delimPos == std::string::npos || delimPos == 0)
+    {
+        throw CommandLineOptionException(arg.c_str(), "Failed to parse <path@cycle> pair.");
+    }
+
+    const auto cycleStr = arg.substr(delimPos + 1);
+    char* pEnd;
+    const auto cycle = std::strtol(cycleStr.c_str(), &pEnd, 10);
+
+    if (cycleStr.empty() || *pEnd != '\0' || cycle < 0 || cycle > std::numeric_limits<int>::max())
+    {
+        throw CommandLineOptionException(arg.c_str(), "Failed to parse cycle.");
+    }
+
+    m_SaveSnapshotPath = arg.substr(0, delimPos);
+    m_SaveSnapshotCycle = static_cast<int>(cycle);
+}
+
 }}
@@ -16,11 +16,13 @@
 
 #pragma once
 
+#include <memory>
 #include <string>
 #include <vector>
 
 #include <rafi/emu.h>
 
+#include "ElfFile.h"
 #include "TraceLoggerConfig.h"
 
 namespace rafi { namespace emu {
@@ -44,16 +46,35 @@ class CommandLineOption
 public:
     CommandLineOption(int argc, char** argv);
 
+    bool IsBasicBlockEnabled() const;
+    bool IsCheckpointEnabled() const;
+    bool IsFileMappingEnabled() const;
+    bool IsForkEnabled() const;
     bool IsGdbEnabled() const;
     bool IsHostIoEnabled() const;
+    bool IsIdleSkipEnabled() const;
+    bool IsJitEnabled() const;
+    bool IsLoadElfEnabled() const;
+    bool IsSaveSnapshotEnabled() const;
+
+    // Valid only if IsLoadElfEnabled() returns true.
+    const ElfFile& GetElfFile() const;
 
     const TraceLoggerConfig& GetTraceLoggerConfig() const;
+    const std::vector<LoadOption>& GetForkLoadOptions() const;
     const std::vector<LoadOption>& GetLoadOptions() const;
     XLEN GetXLEN() const;
 
+    const std::string& GetCheckpointPath() const;
+    const std::vector<std::string>& GetLoadSnapshotPaths() const;
+    const std::string& GetSaveSnapshotPath() const;
+
+    int GetCheckpointInterval() const;
     int GetCycle() const;
     int GetDumpSkipCycle() const;
+    int GetForkCycle() const;
     int GetGdbPort() const;
+    int GetSaveSnapshotCycle() const;
 
     size_t GetRamSize() const;
 
@@ -65,15 +86,27 @@ private:
     static const int DefaultRamSize = 64 * 1024 * 1024;
 
     uint64_t ParseHex(const std::string str);
+    void ParseElf(bool useXLEN, bool usePc, bool useHostIoAddress);
+    void ParseSaveSnapshot(const std::string& arg);
 
+    std::unique_ptr<ElfFile> m_pElfFile;
     TraceLoggerConfig m_TraceLoggerConfig;
+    std::vector<LoadOption> m_ForkLoadOptions;
     std::vector<LoadOption> m_LoadOptions;
 
+    std::string m_CheckpointPath;
+    std::string m_LoadElfPath;
+    std::vector<std::string> m_LoadSnapshotPaths;
+    std::string m_SaveSnapshotPath;
+
     XLEN m_XLEN {XLEN::XLEN32};
 
+    int m_CheckpointInterval {0};
     int m_Cycle {0};
     int m_DumpSkipCycle {0};
+    int m_ForkCycle {0};
     int m_GdbPort {0};
+    int m_SaveSnapshotCycle {0};
 
     size_t m_RamSize {0};
 
@@ -81,8 +114,16 @@ private:
     uint64_t m_HostIoAddress {0};
     uint64_t m_Pc {0};
 
+    bool m_BasicBlockEnabled {false};
+    bool m_CheckpointEnabled {false};
+    bool m_FileMappingEnabled {false};
+    bool m_ForkEnabled {false};
     bool m_GdbEnabled {false};
     bool m_HostIoEnabled {false};
+    bool m_IdleSkipEnabled {false};
+    bool m_JitEnabled {false};
+    bool m_LoadElfEnabled {false};
+    bool m_SaveSnapshotEnabled {false};
 };
 
 }}
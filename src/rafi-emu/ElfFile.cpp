@@ -0,0 +1,299 @@
+/*
+ * Copyright 2018 Akifumi Fujita
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+#include <rafi/emu.h>
+
+#include "ElfFile.h"
+
+namespace rafi { namespace emu {
+
+namespace {
+
+const int EI_CLASS = 4;
+const int EI_DATA = 5;
+const int EI_NIDENT = 16;
+
+const uint8_t ELFCLASS32 = 1;
+const uint8_t ELFCLASS64 = 2;
+const uint8_t ELFDATA2LSB = 1;
+
+const uint16_t ET_EXEC = 2;
+const uint16_t EM_RISCV = 243;
+
+const uint32_t PT_LOAD = 1;
+const uint32_t SHT_SYMTAB = 2;
+
+struct Elf32_Ehdr
+{
+    uint8_t e_ident[EI_NIDENT];
+    uint16_t e_type;
+    uint16_t e_machine;
+    uint32_t e_version;
+    uint32_t e_entry;
+    uint32_t e_phoff;
+    uint32_t e_shoff;
+    uint32_t e_flags;
+    uint16_t e_ehsize;
+    uint16_t e_phentsize;
+    uint16_t e_phnum;
+    uint16_t e_shentsize;
+    uint16_t e_shnum;
+    uint16_t e_shstrndx;
+};
+
+struct Elf64_Ehdr
+{
+    uint8_t e_ident[EI_NIDENT];
+    uint16_t e_type;
+    uint16_t e_machine;
+    uint32_t e_version;
+    uint64_t e_entry;
+    uint64_t e_phoff;
+    uint64_t e_shoff;
+    uint32_t e_flags;
+    uint16_t e_ehsize;
+    uint16_t e_phentsize;
+    uint16_t e_phnum;
+    uint16_t e_shentsize;
+    uint16_t e_shnum;
+    uint16_t e_shstrndx;
+};
+
+struct Elf32_Phdr
+{
+    uint32_t p_type;
+    uint32_t p_offset;
+    uint32_t p_vaddr;
+    uint32_t p_paddr;
+    uint32_t p_filesz;
+    uint32_t p_memsz;
+    uint32_t p_flags;
+    uint32_t p_align;
+};
+
+struct Elf64_Phdr
+{
+    uint32_t p_type;
+    uint32_t p_flags;
+    uint64_t p_offset;
+    uint64_t p_vaddr;
+    uint64_t p_paddr;
+    uint64_t p_filesz;
+    uint64_t p_memsz;
+    uint64_t p_align;
+};
+
+struct Elf32_Shdr
+{
+    uint32_t sh_name;
+    uint32_t sh_type;
+    uint32_t sh_flags;
+    uint32_t sh_addr;
+    uint32_t sh_offset;
+    uint32_t sh_size;
+    uint32_t sh_link;
+    uint32_t sh_info;
+    uint32_t sh_addralign;
+    uint32_t sh_entsize;
+};
+
+struct Elf64_Shdr
+{
+    uint32_t sh_name;
+    uint32_t sh_type;
+    uint64_t sh_flags;
+    uint64_t sh_addr;
+    uint64_t sh_offset;
+    uint64_t sh_size;
+    uint32_t sh_link;
+    uint32_t sh_info;
+    uint64_t sh_addralign;
+    uint64_t sh_entsize;
+};
+
+struct Elf32_Sym
+{
+    uint32_t st_name;
+    uint32_t st_value;
+    uint32_t st_size;
+    uint8_t st_info;
+    uint8_t st_other;
+    uint16_t st_shndx;
+};
+
+struct Elf64_Sym
+{
+    uint32_t st_name;
+    uint8_t st_info;
+    uint8_t st_other;
+    uint16_t st_shndx;
+    uint64_t st_value;
+    uint64_t st_size;
+};
+
+}
+
+ElfFile::ElfFile(const char* path)
+    : m_Path(path)
+{
+    std::ifstream f;
+    f.open(path, std::fstream::binary | std::fstream::in);
+    if (!f.is_open())
+    {
+        RAFI_EMU_ERROR("Failed to open file: %s\n", path);
+    }
+
+    m_Body.assign(std::istreambuf_iterator<char>(f), std::istreambuf_iterator<char>());
+    f.close();
+
+    if (m_Body.size() < EI_NIDENT || std::memcmp(m_Body.data(), "\x7f" "ELF", 4) != 0)
+    {
+        RAFI_EMU_ERROR("%s is not an ELF file.\n", path);
+    }
+    if (m_Body[EI_DATA] != ELFDATA2LSB)
+    {
+        RAFI_EMU_ERROR("%s is not a little endian ELF file.\n", path);
+    }
+
+    switch (m_Body[EI_CLASS])
+    {
+    case ELFCLASS32:
+        m_XLEN = XLEN::XLEN32;
+        Parse<Elf32_Ehdr, Elf32_Phdr, Elf32_Shdr, Elf32_Sym>();
+        break;
+    case ELFCLASS64:
+        m_XLEN = XLEN::XLEN64;
+        Parse<Elf64_Ehdr, Elf64_Phdr, Elf64_Shdr, Elf64_Sym>();
+        break;
+    default:
+        RAFI_EMU_ERROR("%s has unknown ELF class %d.\n", path, m_Body[EI_CLASS]);
+    }
+}
+
+const std::string& ElfFile::GetPath() const
+{
+    return m_Path;
+}
+
+XLEN ElfFile::GetXLEN() const
+{
+    return m_XLEN;
+}
+
+uint64_t ElfFile::GetEntry() const
+{
+    return m_Entry;
+}
+
+const std::vector<ElfSegment>& ElfFile::GetLoadSegments() const
+{
+    return m_LoadSegments;
+}
+
+const char* ElfFile::GetSegmentData(const ElfSegment& segment) const
+{
+    return m_Body.data() + segment.fileOffset;
+}
+
+bool ElfFile::FindSymbol(uint64_t* pOutValue, const char* name) const
+{
+    for (const auto& symbol: m_Symbols)
+    {
+        if (symbol.name == name)
+        {
+            *pOutValue = symbol.value;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+template <typename Ehdr, typename Phdr, typename Shdr, typename Sym>
+void ElfFile::Parse()
+{
+    const auto ehdr = ReadStruct<Ehdr>(0);
+
+    if (ehdr.e_type != ET_EXEC || ehdr.e_machine != EM_RISCV)
+    {
+        RAFI_EMU_ERROR("%s is not a RISC-V executable.\n", m_Path.c_str());
+    }
+
+    m_Entry = ehdr.e_entry;
+
+    for (int i = 0; i < ehdr.e_phnum; i++)
+    {
+        const auto phdr = ReadStruct<Phdr>(ehdr.e_phoff + static_cast<uint64_t>(i) * ehdr.e_phentsize);
+
+        if (phdr.p_type != PT_LOAD || phdr.p_memsz == 0)
+        {
+            continue;
+        }
+        if (phdr.p_offset + phdr.p_filesz > m_Body.size() || phdr.p_filesz > phdr.p_memsz)
+        {
+            RAFI_EMU_ERROR("%s has a broken program header.\n", m_Path.c_str());
+        }
+
+        m_LoadSegments.push_back({ phdr.p_paddr, phdr.p_offset, phdr.p_filesz, phdr.p_memsz });
+    }
+
+    // Symbols are optional (stripped executables have no symbol table).
+    for (int i = 0; i < ehdr.e_shnum; i++)
+    {
+        const auto shdr = ReadStruct<Shdr>(ehdr.e_shoff + static_cast<uint64_t>(i) * ehdr.e_shentsize);
+
+        if (shdr.sh_type != SHT_SYMTAB || shdr.sh_entsize == 0)
+        {
+            continue;
+        }
+
+        const auto strtab = ReadStruct<Shdr>(ehdr.e_shoff + static_cast<uint64_t>(shdr.sh_link) * ehdr.e_shentsize);
+
+        for (uint64_t offset = 0; offset + shdr.sh_entsize <= shdr.sh_size; offset += shdr.sh_entsize)
+        {
+            const auto sym = ReadStruct<Sym>(shdr.sh_offset + offset);
+            const auto nameOffset = strtab.sh_offset + sym.st_name;
+
+            if (sym.st_name == 0 || sym.st_name >= strtab.sh_size || nameOffset >= m_Body.size())
+            {
+                continue;
+            }
+
+            const auto nameLength = strnlen(&m_Body[nameOffset], m_Body.size() - nameOffset);
+
+            m_Symbols.push_back({ std::string(&m_Body[nameOffset], nameLength), sym.st_value });
+        }
+    }
+}
+
+template <typename T>
+T ElfFile::ReadStruct(uint64_t offset) const
+{
+    if (offset + sizeof(T) > m_Body.size())
+    {
+        RAFI_EMU_ERROR("%s is truncated.\n", m_Path.c_str());
+    }
+
+    T value;
+    std::memcpy(&value, &m_Body[offset], sizeof(T));
+    return value;
+}
+
+}}
@@ -0,0 +1,75 @@
+/*
+ * Copyright 2018 Akifumi Fujita
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <rafi/emu.h>
+
+namespace rafi { namespace emu {
+
+// PT_LOAD segment. Bytes after fileSize up to memorySize are zero-filled on load.
+struct ElfSegment
+{
+    uint64_t address;
+    uint64_t fileOffset;
+    uint64_t fileSize;
+    uint64_t memorySize;
+};
+
+// Little endian RISC-V executable (ELF32 or ELF64)
+class ElfFile
+{
+public:
+    explicit ElfFile(const char* path);
+
+    const std::string& GetPath() const;
+    XLEN GetXLEN() const;
+    uint64_t GetEntry() const;
+    const std::vector<ElfSegment>& GetLoadSegments() const;
+
+    // Returns the fileSize bytes of the segment in the file.
+    const char* GetSegmentData(const ElfSegment& segment) const;
+
+    // Returns false if the symbol does not exist.
+    bool FindSymbol(uint64_t* pOutValue, const char* name) const;
+
+private:
+    template <typename Ehdr, typename Phdr, typename Shdr, typename Sym>
+    void Parse();
+
+    template <typename T>
+    T ReadStruct(uint64_t offset) const;
+
+    std::string m_Path;
+    std::vector<char> m_Body;
+    std::vector<ElfSegment> m_LoadSegments;
+
+    struct Symbol
+    {
+        std::string name;
+        uint64_t value;
+    };
+    std::vector<Symbol> m_Symbols;
+
+    XLEN m_XLEN {XLEN::XLEN32};
+    uint64_t m_Entry {0};
+};
+
+}}
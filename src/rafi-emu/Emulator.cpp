@@ -14,23 +14,39 @@
  * limitations under the License.
  */
 
+#include <algorithm>
+#include <cstdio>
+#include <iostream>
+#include <limits>
+#include <string>
+
+#ifndef WIN32
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
 #include <rafi/emu.h>
 
 #include "Emulator.h"
+#include "Snapshot.h"
 
 namespace rafi { namespace emu {
 
-Emulator::Emulator(CommandLineOption option)
-    : m_Option(option)
-    , m_System(option.GetXLEN(), option.GetPc(), option.GetRamSize())
-    , m_Logger(option.GetXLEN(), option.GetTraceLoggerConfig(), &m_System)
+Emulator::Emulator(const EmulatorConfig& config)
+    : m_Config(config)
+    , m_System(config.xlen, config.pc, config.ramSize)
+    , m_Logger(config.xlen, config.traceLoggerConfig, &m_System)
 {
-    if (option.IsHostIoEnabled())
+    if (config.hostIoEnabled)
     {
-        m_System.SetHostIoAddress(option.GetHostIoAddress());
+        m_System.SetHostIoAddress(config.hostIoAddress);
     }
 
-    m_System.SetDtbAddress(option.GetDtbAddress());
+    m_System.SetDtbAddress(config.dtbAddress);
+    m_System.SetBasicBlockEnabled(config.basicBlockEnabled || config.jitEnabled);
+    m_System.SetJitEnabled(config.jitEnabled);
+    m_System.SetIdleSkipEnabled(config.idleSkipEnabled);
+    m_System.SetFileMappingEnabled(config.fileMappingEnabled);
 }
 
 Emulator::~Emulator()
@@ -42,6 +58,109 @@ void Emulator::LoadFileToMemory(const char* path, paddr_t address)
     m_System.LoadFileToMemory(path, address);
 }
 
+void Emulator::LoadElfToMemory(const ElfFile& elf)
+{
+    if (elf.GetXLEN() != m_Config.xlen)
+    {
+        RAFI_EMU_ERROR("XLEN of %s differs from the emulator.\n", elf.GetPath().c_str());
+    }
+
+    for (const auto& segment: elf.GetLoadSegments())
+    {
+        m_System.LoadSegmentToMemory(elf.GetSegmentData(segment), segment.fileSize, segment.memorySize, segment.address);
+    }
+}
+
+// Snapshot holds emulator cycle and xlen in addition to the system state.
+// Incremental snapshot also holds the cycle of the previous snapshot to check the loading order.
+void Emulator::LoadSnapshot(const char* path)
+{
+    SnapshotReader reader(path);
+
+    XLEN xlen;
+    reader.Read(&xlen);
+
+    if (xlen != m_Config.xlen)
+    {
+        RAFI_EMU_ERROR("XLEN of snapshot differs from the emulator.\n");
+    }
+
+    if (reader.GetType() == SnapshotType::Incremental)
+    {
+        int previousCycle;
+        reader.Read(&previousCycle);
+
+        if (!m_SnapshotLoaded || previousCycle != m_Cycle)
+        {
+            RAFI_EMU_ERROR("Incremental snapshot %s must be loaded after the snapshot @ cycle %d.\n", path, previousCycle);
+        }
+    }
+
+    reader.Read(&m_Cycle);
+    m_System.LoadState(&reader);
+    m_System.ClearDirtyPages();
+
+    m_SnapshotLoaded = true;
+}
+
+void Emulator::SaveSnapshot(const char* path, SnapshotType type) const
+{
+    SnapshotWriter writer(path, type);
+
+    writer.Write(m_Config.xlen);
+
+    if (type == SnapshotType::Incremental)
+    {
+        writer.Write(m_LastCheckpointCycle);
+    }
+
+    writer.Write(m_Cycle);
+    m_System.SaveState(&writer);
+}
+
+int Emulator::Fork(int forkIndex)
+{
+#ifdef WIN32
+    static_cast<void>(forkIndex);
+    RAFI_EMU_NOT_IMPLEMENTED;
+#else
+    // Buffered outputs must not be written twice by both processes.
+    m_Logger.Flush();
+    std::cout.flush();
+    std::fflush(nullptr);
+
+    const auto pid = fork();
+    if (pid < 0)
+    {
+        RAFI_EMU_ERROR("Failed to fork.\n");
+    }
+
+    if (pid == 0)
+    {
+        m_PathSuffix = ".fork" + std::to_string(forkIndex);
+        m_Logger.Reopen(m_Config.traceLoggerConfig.path + m_PathSuffix);
+    }
+
+    return static_cast<int>(pid);
+#endif
+}
+
+int Emulator::WaitForkedProcess(int pid)
+{
+#ifdef WIN32
+    static_cast<void>(pid);
+    RAFI_EMU_NOT_IMPLEMENTED;
+#else
+    int status;
+    if (waitpid(pid, &status, 0) < 0)
+    {
+        RAFI_EMU_ERROR("Failed to wait process %d.\n", pid);
+    }
+
+    return WIFEXITED(status) ? WEXITSTATUS(status) : 1;
+#endif
+}
+
 void Emulator::PrintStatus() const
 {
     m_System.PrintStatus();
@@ -52,12 +171,37 @@ int Emulator::GetCycle() const
     return m_Cycle;
 }
 
+uint32_t Emulator::GetHostIoValue() const
+{
+    return m_System.GetHostIoValue();
+}
+
 void Emulator::Process(EmulationStop condition, int cycle)
 {
     while (m_Cycle < cycle || cycle == CycleForever)
     {
-        const bool dumpEnabled = m_Cycle >= m_Option.GetDumpSkipCycle();
-        
+        if (m_Config.saveSnapshotEnabled && m_Cycle == m_Config.saveSnapshotCycle && !m_SnapshotSaved)
+        {
+            SaveSnapshot((m_Config.saveSnapshotPath + m_PathSuffix).c_str(), SnapshotType::Full);
+            m_SnapshotSaved = true;
+
+            std::cout << "Snapshot saved @ cycle " << std::dec << m_Cycle << std::endl;
+        }
+
+        if (m_Config.checkpointEnabled && m_Cycle == GetNextCheckpointCycle())
+        {
+            SaveCheckpoint();
+        }
+
+        const bool dumpEnabled = m_Cycle >= m_Config.dumpSkipCycle;
+        const bool eventEnabled = dumpEnabled && m_Config.traceLoggerConfig.enabled;
+
+        if (eventEnabled != m_EventEnabled)
+        {
+            m_System.SetEventEnabled(eventEnabled);
+            m_EventEnabled = eventEnabled;
+        }
+
         if (dumpEnabled)
         {
             m_Logger.BeginCycle(cycle, m_System.GetPc());
@@ -73,7 +217,7 @@ void Emulator::Process(EmulationStop condition, int cycle)
             break;
         }
 
-        ProcessCycle();
+        const auto processedCycle = m_System.ProcessCycles(GetProcessableCycle(cycle, dumpEnabled));
 
         if (dumpEnabled)
         {
@@ -86,7 +230,7 @@ void Emulator::Process(EmulationStop condition, int cycle)
             break;
         }
 
-        m_Cycle++;
+        m_Cycle += processedCycle;
     }
 }
 
@@ -130,6 +274,64 @@ void Emulator::CopyIntReg(trace::NodeIntReg64* pOut) const
     m_System.CopyIntReg(pOut);
 }
 
+// Cycles which can be processed at once. Each cycle must be processed separately while dumping.
+int Emulator::GetProcessableCycle(int cycle, bool dumpEnabled) const
+{
+    int processableCycle = std::numeric_limits<int>::max();
+
+    if (cycle != CycleForever)
+    {
+        processableCycle = cycle - m_Cycle;
+    }
+
+    if (m_Config.saveSnapshotEnabled && m_Cycle < m_Config.saveSnapshotCycle)
+    {
+        processableCycle = std::min(processableCycle, m_Config.saveSnapshotCycle - m_Cycle);
+    }
+
+    if (m_Config.checkpointEnabled)
+    {
+        processableCycle = std::min(processableCycle, GetNextCheckpointCycle() - m_Cycle);
+    }
+
+    if (m_Config.traceLoggerConfig.enabled)
+    {
+        if (dumpEnabled)
+        {
+            return 1;
+        }
+
+        processableCycle = std::min(processableCycle, m_Config.dumpSkipCycle - m_Cycle);
+    }
+
+    return processableCycle;
+}
+
+// The first checkpoint is saved at the current cycle.
+int Emulator::GetNextCheckpointCycle() const
+{
+    if (m_CheckpointCount == 0)
+    {
+        return m_Cycle;
+    }
+
+    const auto interval = m_Config.checkpointInterval;
+
+    return (m_LastCheckpointCycle / interval + 1) * interval;
+}
+
+void Emulator::SaveCheckpoint()
+{
+    const auto type = m_CheckpointCount == 0 ? SnapshotType::Full : SnapshotType::Incremental;
+    const auto path = m_Config.checkpointPath + m_PathSuffix + "." + std::to_string(m_CheckpointCount) + ".snap";
+
+    SaveSnapshot(path.c_str(), type);
+    m_System.ClearDirtyPages();
+
+    m_CheckpointCount++;
+    m_LastCheckpointCycle = m_Cycle;
+}
+
 bool Emulator::IsStopConditionFilledPre(EmulationStop condition)
 {
     if (condition & EmulationStop_HostIo)
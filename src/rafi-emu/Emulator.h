@@ -16,9 +16,12 @@
 
 #pragma once
 
+#include <string>
+
 #include <rafi/emu.h>
 
-#include "CommandLineOption.h"
+#include "ElfFile.h"
+#include "EmulatorConfig.h"
 #include "System.h"
 #include "TraceLogger.h"
 #include "IEmulator.h"
@@ -28,12 +31,24 @@ namespace rafi { namespace emu {
 class Emulator final : public IEmulator
 {
 public:
-    Emulator(CommandLineOption option);
+    explicit Emulator(const EmulatorConfig& config);
     virtual ~Emulator();
 
     void LoadFileToMemory(const char* path, paddr_t address);
+    void LoadElfToMemory(const ElfFile& elf);
+    void LoadSnapshot(const char* path);
+    void SaveSnapshot(const char* path, SnapshotType type) const;
+
+    // Clones the machine into a child process which shares memory copy-on-write (POSIX only).
+    // Returns the process id of the child in the parent and 0 in the child like fork().
+    // Output files of the child have suffix ".fork<forkIndex>".
+    int Fork(int forkIndex);
+
+    // Waits for a forked process and returns its exit status.
+    static int WaitForkedProcess(int pid);
     void PrintStatus() const;
     int GetCycle() const;
+    uint32_t GetHostIoValue() const;
 
     void Process(EmulationStop condition, int cycle);
     void Process(EmulationStop condition) override;
@@ -53,11 +68,26 @@ private:
     bool IsStopConditionFilledPre(EmulationStop condition);
     bool IsStopConditionFilledPost(EmulationStop condition);
 
-    const CommandLineOption& m_Option;
+    int GetProcessableCycle(int cycle, bool dumpEnabled) const;
+    int GetNextCheckpointCycle() const;
+
+    void SaveCheckpoint();
+
+    const EmulatorConfig m_Config;
     System m_System;
     TraceLogger m_Logger;
 
     int m_Cycle{0};
+    bool m_EventEnabled{false};
+    bool m_SnapshotSaved{false};
+    bool m_SnapshotLoaded{false};
+
+    // Checkpoints are saved at multiples of the interval. The first one is a full snapshot.
+    int m_CheckpointCount{0};
+    int m_LastCheckpointCycle{0};
+
+    // Suffix of output file paths in a forked process
+    std::string m_PathSuffix;
 };
 
 }}
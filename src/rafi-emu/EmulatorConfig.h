@@ -0,0 +1,55 @@
+/*
+ * Copyright 2018 Akifumi Fujita
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <string>
+
+#include <rafi/emu.h>
+
+#include "TraceLoggerConfig.h"
+
+namespace rafi { namespace emu {
+
+// Settings of Emulator. rafi-emu fills them from its command line options.
+struct EmulatorConfig
+{
+    XLEN xlen {XLEN::XLEN32};
+    vaddr_t pc {0};
+    size_t ramSize {0};
+    paddr_t dtbAddress {0};
+
+    bool hostIoEnabled {false};
+    paddr_t hostIoAddress {0};
+
+    bool basicBlockEnabled {false};
+    bool jitEnabled {false};
+    bool idleSkipEnabled {false};
+    bool fileMappingEnabled {false};
+
+    TraceLoggerConfig traceLoggerConfig {};
+    int dumpSkipCycle {0};
+
+    bool saveSnapshotEnabled {false};
+    int saveSnapshotCycle {0};
+    std::string saveSnapshotPath;
+
+    bool checkpointEnabled {false};
+    int checkpointInterval {0};
+    std::string checkpointPath;
+};
+
+}}
@@ -0,0 +1,147 @@
+/*
+ * Copyright 2018 Akifumi Fujita
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <thread>
+
+#include <rafi/emu.h>
+
+#include "Emulator.h"
+#include "Farm.h"
+
+namespace rafi { namespace emu {
+
+Farm::Farm(int threadCount)
+    : m_Queues(std::max(1, threadCount))
+{
+}
+
+std::vector<FarmResult> Farm::Run(const std::vector<FarmJob>& jobs)
+{
+    const auto threadCount = static_cast<int>(m_Queues.size());
+
+    // Jobs are distributed in round robin. Stealing balances jobs with different lengths.
+    for (size_t i = 0; i < jobs.size(); i++)
+    {
+        m_Queues[i % threadCount].jobIndices.push_back(i);
+    }
+
+    std::vector<FarmResult> results(jobs.size());
+    std::vector<std::thread> threads;
+
+    for (int i = 0; i < threadCount; i++)
+    {
+        threads.emplace_back(&Farm::ProcessThread, this, i, std::cref(jobs), &results);
+    }
+
+    for (auto& thread: threads)
+    {
+        thread.join();
+    }
+
+    return results;
+}
+
+FarmResult Farm::RunJob(const FarmJob& job)
+{
+    FarmResult result = { false, 0, 0, 0 };
+
+    try
+    {
+        const bool hostIoEnabled = (job.condition & EmulationStop_HostIo) != 0;
+
+        EmulatorConfig config;
+
+        config.xlen = job.xlen;
+        config.pc = job.pc;
+        config.ramSize = job.ramSize;
+        config.hostIoEnabled = hostIoEnabled;
+        config.hostIoAddress = job.hostIoAddress;
+        config.basicBlockEnabled = job.basicBlockEnabled;
+        config.jitEnabled = job.jitEnabled;
+
+        // Emulator is too large for stack of threads.
+        auto pEmulator = std::make_unique<Emulator>(config);
+
+        for (const auto& image: job.images)
+        {
+            pEmulator->LoadFileToMemory(image.path.c_str(), image.address);
+        }
+
+        pEmulator->Process(job.condition, job.cycle);
+
+        result.completed = true;
+        result.cycle = pEmulator->GetCycle();
+        result.hostIoValue = hostIoEnabled ? pEmulator->GetHostIoValue() : 0;
+        result.pc = pEmulator->GetPc();
+    }
+    catch (const RafiEmuException&)
+    {
+    }
+
+    return result;
+}
+
+void Farm::ProcessThread(int threadIndex, const std::vector<FarmJob>& jobs, std::vector<FarmResult>* pOutResults)
+{
+    size_t jobIndex;
+
+    while (PopJob(&jobIndex, threadIndex) || StealJob(&jobIndex, threadIndex))
+    {
+        // Each job writes a different element, so results need no lock.
+        (*pOutResults)[jobIndex] = RunJob(jobs[jobIndex]);
+    }
+}
+
+bool Farm::PopJob(size_t* pOutJobIndex, int threadIndex)
+{
+    auto& queue = m_Queues[threadIndex];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+
+    if (queue.jobIndices.empty())
+    {
+        return false;
+    }
+
+    *pOutJobIndex = queue.jobIndices.front();
+    queue.jobIndices.pop_front();
+    return true;
+}
+
+// Jobs are never added while running, so a thread can finish once all queues are empty.
+bool Farm::StealJob(size_t* pOutJobIndex, int threadIndex)
+{
+    const auto threadCount = static_cast<int>(m_Queues.size());
+
+    for (int i = 1; i < threadCount; i++)
+    {
+        auto& queue = m_Queues[(threadIndex + i) % threadCount];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+
+        if (!queue.jobIndices.empty())
+        {
+            *pOutJobIndex = queue.jobIndices.back();
+            queue.jobIndices.pop_back();
+            return true;
+        }
+    }
+
+    return false;
+}
+
+}}
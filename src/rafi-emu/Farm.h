@@ -0,0 +1,91 @@
+/*
+ * Copyright 2018 Akifumi Fujita
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <deque>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <rafi/emu.h>
+
+#include "IEmulator.h"
+
+namespace rafi { namespace emu {
+
+struct FarmImage
+{
+    std::string path;
+    paddr_t address;
+};
+
+// An independent emulation which runs until the stop condition is met or the cycle budget runs out.
+struct FarmJob
+{
+    XLEN xlen;
+    vaddr_t pc;
+    size_t ramSize;
+    std::vector<FarmImage> images;
+
+    // Host io is enabled only if condition includes EmulationStop_HostIo.
+    EmulationStop condition;
+    paddr_t hostIoAddress;
+    int cycle;
+
+    bool basicBlockEnabled;
+    bool jitEnabled;
+};
+
+struct FarmResult
+{
+    // false if emulation is stopped by exception.
+    bool completed;
+
+    int cycle;
+    // 0 if host io is not enabled for the job.
+    uint32_t hostIoValue;
+    vaddr_t pc;
+};
+
+// Runs jobs in their own Emulator on a pool of threads.
+// Each thread takes jobs from the front of its own queue and steals from the back of the others' ones when it becomes empty.
+class Farm
+{
+public:
+    explicit Farm(int threadCount);
+
+    // Results are stored in order of jobs.
+    std::vector<FarmResult> Run(const std::vector<FarmJob>& jobs);
+
+    static FarmResult RunJob(const FarmJob& job);
+
+private:
+    struct WorkQueue
+    {
+        std::mutex mutex;
+        std::deque<size_t> jobIndices;
+    };
+
+    void ProcessThread(int threadIndex, const std::vector<FarmJob>& jobs, std::vector<FarmResult>* pOutResults);
+
+    bool PopJob(size_t* pOutJobIndex, int threadIndex);
+    bool StealJob(size_t* pOutJobIndex, int threadIndex);
+
+    std::vector<WorkQueue> m_Queues;
+};
+
+}}
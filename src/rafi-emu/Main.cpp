@@ -28,10 +28,80 @@
 #include "Socket.h"
 #include "Emulator.h"
 
+namespace {
+
+rafi::emu::EmulatorConfig MakeEmulatorConfig(const rafi::emu::CommandLineOption& option)
+{
+    rafi::emu::EmulatorConfig config;
+
+    config.xlen = option.GetXLEN();
+    config.pc = option.GetPc();
+    config.ramSize = option.GetRamSize();
+    config.dtbAddress = option.GetDtbAddress();
+
+    config.hostIoEnabled = option.IsHostIoEnabled();
+    config.hostIoAddress = option.GetHostIoAddress();
+
+    config.basicBlockEnabled = option.IsBasicBlockEnabled();
+    config.jitEnabled = option.IsJitEnabled();
+    config.idleSkipEnabled = option.IsIdleSkipEnabled();
+    config.fileMappingEnabled = option.IsFileMappingEnabled();
+
+    config.traceLoggerConfig = option.GetTraceLoggerConfig();
+    config.dumpSkipCycle = option.GetDumpSkipCycle();
+
+    config.saveSnapshotEnabled = option.IsSaveSnapshotEnabled();
+    config.saveSnapshotCycle = option.GetSaveSnapshotCycle();
+    config.saveSnapshotPath = option.GetSaveSnapshotPath();
+
+    config.checkpointEnabled = option.IsCheckpointEnabled();
+    config.checkpointInterval = option.GetCheckpointInterval();
+    config.checkpointPath = option.GetCheckpointPath();
+
+    return config;
+}
+
+// Forks the emulator for each --fork-load. Returns the fork index in forked processes and -1 in the parent.
+int ForkEmulator(rafi::emu::Emulator* pEmulator, const rafi::emu::CommandLineOption& option, int* pOutExitStatus)
+{
+    const auto& loadOptions = option.GetForkLoadOptions();
+    std::vector<int> pids;
+
+    for (size_t i = 0; i < loadOptions.size(); i++)
+    {
+        const auto pid = pEmulator->Fork(static_cast<int>(i));
+        if (pid == 0)
+        {
+            pEmulator->LoadFileToMemory(loadOptions[i].GetPath().c_str(), loadOptions[i].GetAddress());
+            return static_cast<int>(i);
+        }
+
+        pids.push_back(pid);
+    }
+
+    *pOutExitStatus = 0;
+
+    for (size_t i = 0; i < pids.size(); i++)
+    {
+        const auto status = rafi::emu::Emulator::WaitForkedProcess(pids[i]);
+
+        std::cout << "Fork " << i << " (" << loadOptions[i].GetPath() << ") exited with status " << status << "." << std::endl;
+
+        if (status != 0)
+        {
+            *pOutExitStatus = status;
+        }
+    }
+
+    return -1;
+}
+
+}
+
 int main(int argc, char** argv)
 {
     rafi::emu::CommandLineOption option(argc, argv);
-    rafi::emu::Emulator emulator(option);
+    rafi::emu::Emulator emulator(MakeEmulatorConfig(option));
 
     try
     {
@@ -46,12 +116,41 @@ int main(int argc, char** argv)
         std::exit(1);
     }
 
+    int forkIndex = -1;
+
     try
     {
+        if (option.IsLoadElfEnabled())
+        {
+            emulator.LoadElfToMemory(option.GetElfFile());
+        }
+
+        for (auto& path: option.GetLoadSnapshotPaths())
+        {
+            emulator.LoadSnapshot(path.c_str());
+        }
+
         const auto condition = option.IsHostIoEnabled()
             ? rafi::emu::EmulationStop_HostIo
             : rafi::emu::EmulationStop_None;
 
+        if (option.IsForkEnabled())
+        {
+            emulator.Process(condition, option.GetForkCycle());
+
+            // Emulation may have been stopped before the fork cycle.
+            if (emulator.GetCycle() == option.GetForkCycle())
+            {
+                int exitStatus = 0;
+
+                forkIndex = ForkEmulator(&emulator, option, &exitStatus);
+                if (forkIndex < 0)
+                {
+                    return exitStatus;
+                }
+            }
+        }
+
         emulator.Process(condition, option.GetCycle());
     }
     catch (rafi::emu::RafiEmuException)
@@ -65,7 +164,7 @@ int main(int argc, char** argv)
         << std::dec << emulator.GetCycle()
         << std::hex << " (0x" << emulator.GetCycle() << ")" << std::endl;
 
-    if (option.IsGdbEnabled())
+    if (option.IsGdbEnabled() && forkIndex < 0)
     {
         rafi::emu::InitializeSocket();
 
@@ -0,0 +1,108 @@
+/*
+ * Copyright 2018 Akifumi Fujita
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cstring>
+
+#include <rafi/emu.h>
+
+#include "Snapshot.h"
+
+namespace rafi { namespace emu {
+
+SnapshotWriter::SnapshotWriter(const char* path, SnapshotType type)
+    : m_Type(type)
+{
+    m_Stream.open(path, std::fstream::binary | std::fstream::out);
+    if (!m_Stream.is_open())
+    {
+        RAFI_EMU_ERROR("Failed to open file: %s\n", path);
+    }
+
+    SnapshotHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.signature, SnapshotSignature, sizeof(header.signature));
+    header.version = SnapshotVersion;
+    header.type = type;
+
+    Write(header);
+}
+
+SnapshotWriter::~SnapshotWriter()
+{
+    m_Stream.close();
+}
+
+SnapshotType SnapshotWriter::GetType() const
+{
+    return m_Type;
+}
+
+void SnapshotWriter::Write(const void* pBuffer, size_t size)
+{
+    m_Stream.write(reinterpret_cast<const char*>(pBuffer), size);
+    if (!m_Stream)
+    {
+        RAFI_EMU_ERROR("Failed to write snapshot.\n");
+    }
+}
+
+SnapshotReader::SnapshotReader(const char* path)
+{
+    m_Stream.open(path, std::fstream::binary | std::fstream::in);
+    if (!m_Stream.is_open())
+    {
+        RAFI_EMU_ERROR("Failed to open file: %s\n", path);
+    }
+
+    SnapshotHeader header;
+    Read(&header);
+
+    if (std::memcmp(header.signature, SnapshotSignature, sizeof(header.signature)) != 0)
+    {
+        RAFI_EMU_ERROR("%s is not a snapshot file.\n", path);
+    }
+    if (header.version != SnapshotVersion)
+    {
+        RAFI_EMU_ERROR("Snapshot version %u is not supported.\n", header.version);
+    }
+    if (header.type != SnapshotType::Full && header.type != SnapshotType::Incremental)
+    {
+        RAFI_EMU_ERROR("Snapshot type %u is invalid.\n", static_cast<uint32_t>(header.type));
+    }
+
+    m_Type = header.type;
+}
+
+SnapshotReader::~SnapshotReader()
+{
+    m_Stream.close();
+}
+
+SnapshotType SnapshotReader::GetType() const
+{
+    return m_Type;
+}
+
+void SnapshotReader::Read(void* pOutBuffer, size_t size)
+{
+    m_Stream.read(reinterpret_cast<char*>(pOutBuffer), size);
+    if (!m_Stream)
+    {
+        RAFI_EMU_ERROR("Snapshot is truncated.\n");
+    }
+}
+
+}}
@@ -0,0 +1,93 @@
+/*
+ * Copyright 2018 Akifumi Fujita
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <type_traits>
+
+#include <rafi/emu.h>
+
+namespace rafi { namespace emu {
+
+// Incremental snapshots hold only ram pages written after the previous snapshot.
+enum class SnapshotType : uint32_t
+{
+    Full = 0,
+    Incremental = 1,
+};
+
+// Written at the head of snapshot files
+struct SnapshotHeader
+{
+    char signature[8];
+    uint32_t version;
+    SnapshotType type;
+};
+
+const char SnapshotSignature[8] = "RAFISNP";
+const uint32_t SnapshotVersion = 2;
+
+// Snapshot files hold emulated state field by field in host byte order. Host addresses such as pointers are never saved,
+// so a snapshot can be loaded by another process of the same version.
+class SnapshotWriter final
+{
+public:
+    SnapshotWriter(const char* path, SnapshotType type);
+    ~SnapshotWriter();
+
+    SnapshotType GetType() const;
+
+    void Write(const void* pBuffer, size_t size);
+
+    template <typename T>
+    void Write(const T& value)
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+
+        Write(&value, sizeof(value));
+    }
+
+private:
+    std::ofstream m_Stream;
+    SnapshotType m_Type;
+};
+
+class SnapshotReader final
+{
+public:
+    explicit SnapshotReader(const char* path);
+    ~SnapshotReader();
+
+    SnapshotType GetType() const;
+
+    void Read(void* pOutBuffer, size_t size);
+
+    template <typename T>
+    void Read(T* pOut)
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+
+        Read(pOut, sizeof(*pOut));
+    }
+
+private:
+    std::ifstream m_Stream;
+    SnapshotType m_Type;
+};
+
+}}
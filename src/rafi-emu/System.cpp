@@ -14,6 +14,9 @@
  * limitations under the License.
  */
 
+#include <algorithm>
+#include <cinttypes>
+
 #include <rafi/emu.h>
 
 #include "System.h"
@@ -55,12 +58,36 @@ System::System(XLEN xlen, vaddr_t pc, size_t ramSize)
     m_Processor.RegisterTimerInterruptSource(&m_TimerInterruptSource);
 
     m_Clint.RegisterProcessor(&m_Processor);
+    m_Clint.RegisterScheduler(&m_Scheduler);
+    m_Uart16550.RegisterScheduler(&m_Scheduler);
+    m_Uart.RegisterScheduler(&m_Scheduler);
+    m_Timer.RegisterScheduler(&m_Scheduler);
 }
 
 void System::LoadFileToMemory(const char* path, paddr_t address)
 {
     auto location = m_Bus.ConvertToMemoryLocation(address);
     location.pMemory->LoadFile(path, location.offset);
+
+    m_Processor.InvalidateDecodeCache();
+}
+
+// Bytes after dataSize up to memorySize are not written since memory is zero-initialized.
+// Writing them would touch every page of bss.
+void System::LoadSegmentToMemory(const void* pData, size_t dataSize, size_t memorySize, paddr_t address)
+{
+    auto location = m_Bus.ConvertToMemoryLocation(address);
+    const auto offset = static_cast<size_t>(location.offset);
+    const auto capacity = location.pMemory->GetCapacity();
+
+    if (dataSize > memorySize || memorySize > capacity || offset > capacity - memorySize)
+    {
+        RAFI_EMU_ERROR("Segment does not fit in memory: 0x%016" PRIx64 "\n", address);
+    }
+
+    location.pMemory->Write(pData, dataSize, offset);
+
+    m_Processor.InvalidateDecodeCache();
 }
 
 void System::SetDtbAddress(vaddr_t address)
@@ -72,16 +99,71 @@ void System::SetDtbAddress(vaddr_t address)
 void System::SetHostIoAddress(vaddr_t address)
 {
     m_HostIoAddress = address;
+    m_Bus.SetWatchRange(address, sizeof(uint32_t));
+}
+
+void System::SetBasicBlockEnabled(bool enabled)
+{
+    m_Processor.SetBasicBlockEnabled(enabled);
+}
+
+void System::SetJitEnabled(bool enabled)
+{
+    m_Processor.SetJitEnabled(enabled);
+}
+
+void System::SetIdleSkipEnabled(bool enabled)
+{
+    m_IdleSkipEnabled = enabled;
+}
+
+void System::SetFileMappingEnabled(bool enabled)
+{
+    m_Ram.SetFileMappingEnabled(enabled);
+}
+
+void System::SetEventEnabled(bool enabled)
+{
+    m_Processor.SetEventEnabled(enabled);
 }
 
 void System::ProcessCycle()
 {
-    m_Clint.ProcessCycle();
-    m_Uart16550.ProcessCycle();
-    m_Uart.ProcessCycle();
-    m_Timer.ProcessCycle();
+    ProcessCycles(1);
+}
+
+int System::ProcessCycles(int maxCycleCount)
+{
+    m_Bus.ClearWatchRangeWritten();
+
+    int cycleCount = 0;
+
+    while (cycleCount < maxCycleCount)
+    {
+        // Devices change their state only by scheduled events, so processor runs until the next one.
+        const auto processableCycle = m_Scheduler.GetProcessableCycle(maxCycleCount - cycleCount);
+        const auto processedCycle = m_Processor.ProcessCycles(processableCycle);
 
-    m_Processor.ProcessCycle();
+        m_Scheduler.ProcessCycles(processedCycle);
+        cycleCount += processedCycle;
+
+        if (m_IdleSkipEnabled && m_Processor.IsWaitingForInterrupt())
+        {
+            const auto skipCycle = GetIdleSkipCycle(maxCycleCount - cycleCount);
+
+            m_Processor.SkipCycles(skipCycle);
+            m_Scheduler.ProcessCycles(skipCycle);
+            cycleCount += skipCycle;
+        }
+
+        // Return to Emulator to check stop conditions (host io and breakpoint).
+        if (m_Bus.IsWatchRangeWritten() || m_Processor.IsTrapEventExist())
+        {
+            break;
+        }
+    }
+
+    return cycleCount;
 }
 
 bool System::IsValidMemory(paddr_t addr, size_t size) const
@@ -179,6 +261,54 @@ bool System::IsTrapEventExist() const
     return m_Processor.IsTrapEventExist();
 }
 
+// Cycles in which nothing happens while processor waits for interrupt.
+// The timer interrupt is the only one which is raised without processor or scheduled events.
+int System::GetIdleSkipCycle(int maxCycleCount) const
+{
+    const auto timeToInterrupt = m_Clint.GetTimeToInterrupt();
+    if (timeToInterrupt <= 1)
+    {
+        return 0;
+    }
+
+    // Leave a cycle so that time reaches mtimecmp in a processed cycle.
+    return static_cast<int>(std::min<uint64_t>(timeToInterrupt - 1, m_Scheduler.GetProcessableCycle(maxCycleCount)));
+}
+
+void System::SaveState(SnapshotWriter* pWriter) const
+{
+    m_Scheduler.SaveState(pWriter);
+    m_Ram.SaveState(pWriter);
+    m_Rom.SaveState(pWriter);
+    m_Processor.SaveState(pWriter);
+
+    m_Clint.SaveState(pWriter);
+    m_Plic.SaveState(pWriter);
+    m_Uart16550.SaveState(pWriter);
+    m_Uart.SaveState(pWriter);
+    m_Timer.SaveState(pWriter);
+}
+
+// Scheduler and processor are loaded first since devices post events and read time on loading.
+void System::LoadState(SnapshotReader* pReader)
+{
+    m_Scheduler.LoadState(pReader);
+    m_Ram.LoadState(pReader);
+    m_Rom.LoadState(pReader);
+    m_Processor.LoadState(pReader);
+
+    m_Clint.LoadState(pReader);
+    m_Plic.LoadState(pReader);
+    m_Uart16550.LoadState(pReader);
+    m_Uart.LoadState(pReader);
+    m_Timer.LoadState(pReader);
+}
+
+void System::ClearDirtyPages()
+{
+    m_Ram.ClearDirtyPages();
+}
+
 void System::PrintStatus() const
 {
     return m_Processor.PrintStatus();
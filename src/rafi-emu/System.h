@@ -22,6 +22,7 @@
 #include "cpu/Processor.h"
 #include "io/IoInterruptSource.h"
 #include "io/Clint.h"
+#include "io/EventScheduler.h"
 #include "io/Plic.h"
 #include "io/Uart.h"
 #include "io/Uart16550.h"
@@ -31,6 +32,7 @@
 #include "mem/Rom.h"
 
 #include "IEmulator.h"
+#include "Snapshot.h"
 
 namespace rafi { namespace emu {
 
@@ -41,11 +43,18 @@ public:
 
     // Setup
     void LoadFileToMemory(const char* path, paddr_t address);
+    void LoadSegmentToMemory(const void* pData, size_t dataSize, size_t memorySize, paddr_t address);
     void SetDtbAddress(vaddr_t address);
     void SetHostIoAddress(vaddr_t address);
+    void SetBasicBlockEnabled(bool enabled);
+    void SetJitEnabled(bool enabled);
+    void SetEventEnabled(bool enabled);
+    void SetIdleSkipEnabled(bool enabled);
+    void SetFileMappingEnabled(bool enabled);
 
     // Process
     void ProcessCycle();
+    int ProcessCycles(int maxCycleCount);
 
     // for gdbserver
     bool IsValidMemory(paddr_t addr, size_t size) const;
@@ -74,7 +83,16 @@ public:
 
     void PrintStatus() const;
 
+    // for snapshot
+    void SaveState(SnapshotWriter* pWriter) const;
+    void LoadState(SnapshotReader* pReader);
+
+    // Incremental snapshots hold ram pages written after this.
+    void ClearDirtyPages();
+
 private:
+    int GetIdleSkipCycle(int maxCycleCount) const;
+
     static const paddr_t AddrRom = 0x00001000;
     static const paddr_t AddrRam = 0x80000000;
 
@@ -95,6 +113,8 @@ private:
     static const paddr_t AddrUart   = 0x40002000;
     static const paddr_t AddrTimer  = 0x40000000;
 
+    io::EventScheduler m_Scheduler;
+
     bus::Bus m_Bus;
     mem::Ram m_Ram;
     mem::Rom m_Rom;
@@ -122,6 +142,7 @@ private:
     cpu::Processor m_Processor;
 
     uint32_t m_HostIoAddress{0};
+    bool m_IdleSkipEnabled{false};
 };
 
 }}
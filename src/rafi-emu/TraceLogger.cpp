@@ -37,7 +37,7 @@ TraceLogger::TraceLogger(XLEN xlen, const TraceLoggerConfig& config, const Syste
 {
     if (m_Config.enabled)
     {
-        m_pTraceWriter = new TraceIndexWriter(m_Config.path.c_str());
+        m_pTraceWriter = new TraceIndexWriter(m_Config.path.c_str(), m_Config.enableCompression);
     }
 }
 
@@ -49,6 +49,30 @@ TraceLogger::~TraceLogger()
     }
 }
 
+void TraceLogger::Flush()
+{
+    if (!m_Config.enabled)
+    {
+        return;
+    }
+
+    m_pTraceWriter->Flush();
+}
+
+void TraceLogger::Reopen(const std::string& path)
+{
+    if (!m_Config.enabled)
+    {
+        return;
+    }
+
+    // The writer thread does not exist in this process, so the writer cannot be deleted.
+    m_pTraceWriter->CloseInForkedProcess();
+
+    m_Config.path = path;
+    m_pTraceWriter = new TraceIndexWriter(m_Config.path.c_str(), m_Config.enableCompression);
+}
+
 void TraceLogger::BeginCycle(int cycle, vaddr_t pc)
 {
     if (!m_Config.enabled)
@@ -56,7 +80,12 @@ void TraceLogger::BeginCycle(int cycle, vaddr_t pc)
         return;
     }
 
-    m_pCurrentCycle = new BinaryCycleLogger(cycle, m_XLEN, pc);
+    // Cycles are serialized into the buffer of the writer directly.
+    const auto pBuffer = m_pTraceWriter->BeginWrite(BinaryCycleLogger::DefaultBufferSize);
+
+    m_CycleLogger.Reset(pBuffer, BinaryCycleLogger::DefaultBufferSize, cycle, m_XLEN, pc);
+
+    m_Keyframe = m_pTraceWriter->IsSegmentStart();
 }
 
 void TraceLogger::RecordState()
@@ -72,13 +101,13 @@ void TraceLogger::RecordState()
         {
             NodeIntReg32 node;
             m_pSystem->CopyIntReg(&node);
-            m_pCurrentCycle->Add(node);
+            AddRegNode(node, &m_PreviousIntReg32);
         }
         else if (m_XLEN == XLEN::XLEN64)
         {
             NodeIntReg64 node;
             m_pSystem->CopyIntReg(&node);
-            m_pCurrentCycle->Add(node);
+            AddRegNode(node, &m_PreviousIntReg64);
         }
         else
         {
@@ -90,13 +119,13 @@ void TraceLogger::RecordState()
     {
         NodeFpReg node;
         m_pSystem->CopyFpReg(&node, sizeof(node));
-        m_pCurrentCycle->Add(node);
+        AddRegNode(node, &m_PreviousFpReg);
     }
 
     if (m_Config.enableDumpHostIo)
     {
         NodeIo node = { m_pSystem->GetHostIoValue(), 0 };
-        m_pCurrentCycle->Add(node);
+        m_CycleLogger.Add(node);
     }
 
     if (m_Config.enableDumpCsr || m_Config.enableDumpMemory)
@@ -122,7 +151,7 @@ void TraceLogger::RecordEvent()
             opEvent.insn,
             opEvent.privilegeLevel,
         };
-        m_pCurrentCycle->Add(node);
+        m_CycleLogger.Add(node);
     }
 
     if (m_pSystem->IsTrapEventExist())
@@ -139,7 +168,7 @@ void TraceLogger::RecordEvent()
             trapEvent.trapValue,
         };
 
-        m_pCurrentCycle->Add(node);
+        m_CycleLogger.Add(node);
     }
 
     for (int index = 0; index < m_pSystem->GetMemoryAccessEventCount(); index++)
@@ -155,7 +184,7 @@ void TraceLogger::RecordEvent()
             memoryAccessEvent.virtualAddress,
             memoryAccessEvent.physicalAddress,
         };
-        m_pCurrentCycle->Add(node);
+        m_CycleLogger.Add(node);
     }
 
 }
@@ -167,12 +196,24 @@ void TraceLogger::EndCycle()
         return;
     }
 
-    m_pCurrentCycle->Break();
+    m_CycleLogger.Break();
 
-    m_pTraceWriter->Write(m_pCurrentCycle->GetData(), m_pCurrentCycle->GetDataSize());
+    m_pTraceWriter->EndWrite(m_CycleLogger.GetDataSize());
+}
+
+template <typename T>
+void TraceLogger::AddRegNode(const T& node, T* pPrevious)
+{
+    if (m_Keyframe)
+    {
+        m_CycleLogger.Add(node);
+    }
+    else
+    {
+        m_CycleLogger.AddDelta(node, *pPrevious);
+    }
 
-    delete m_pCurrentCycle;
-    m_pCurrentCycle = nullptr;
+    *pPrevious = node;
 }
 
 }}
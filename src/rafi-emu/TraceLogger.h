@@ -17,6 +17,7 @@
 #pragma once
 
 #include <cstdio>
+#include <string>
 
 #include <rafi/trace.h>
 
@@ -36,13 +37,30 @@ public:
     void RecordEvent();
     void EndCycle();
 
+    // Called before fork() so that segments written by the writer thread are not left in the inherited index buffer.
+    void Flush();
+
+    // Called in a forked process. The writer inherited from the parent is abandoned since its buffered data belongs to the parent.
+    void Reopen(const std::string& path);
+
 private:
     XLEN m_XLEN;
     TraceLoggerConfig m_Config;
     const System* m_pSystem {nullptr};
 
-    trace::ITraceWriter* m_pTraceWriter {nullptr};
-    trace::BinaryCycleLogger* m_pCurrentCycle {nullptr};
+    template <typename T>
+    void AddRegNode(const T& node, T* pPrevious);
+
+    trace::TraceIndexWriter* m_pTraceWriter {nullptr};
+    trace::BinaryCycleLogger m_CycleLogger;
+
+    trace::NodeIntReg32 m_PreviousIntReg32;
+    trace::NodeIntReg64 m_PreviousIntReg64;
+    trace::NodeFpReg m_PreviousFpReg;
+
+    // Registers are recorded as delta nodes except keyframes, which hold all registers.
+    // The first cycle of each segment is a keyframe so that segments can be read independently.
+    bool m_Keyframe {false};
 };
 
 }}
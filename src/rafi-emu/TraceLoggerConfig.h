@@ -30,6 +30,7 @@ struct TraceLoggerConfig
     bool enableDumpIntReg;
     bool enableDumpMemory;
     bool enableDumpHostIo;
+    bool enableCompression;
     std::string path;
 };
 
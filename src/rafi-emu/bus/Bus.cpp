@@ -15,6 +15,8 @@
  */
 
 #include <cinttypes>
+#include <cstring>
+
 #include <rafi/emu.h>
 
 #include "Bus.h"
@@ -23,15 +25,20 @@ namespace rafi { namespace emu { namespace bus {
 
 void Bus::Read(void* pOutBuffer, size_t size, paddr_t address)
 {
-    if (IsMemoryAddress(address, size))
+    if (const auto pInfo = FindMemory(address, size); pInfo != nullptr)
     {
-        const auto location = ConvertToMemoryLocation(address);
-        return location.pMemory->Read(pOutBuffer, size, location.offset);
+        if (pInfo->pHostRead != nullptr)
+        {
+            std::memcpy(pOutBuffer, &pInfo->pHostRead[address - pInfo->address], size);
+        }
+        else
+        {
+            pInfo->pMemory->Read(pOutBuffer, size, address - pInfo->address);
+        }
     }
-    else if (IsIoAddress(address, sizeof(uint8_t)))
+    else if (const auto pInfo = FindIo(address, sizeof(uint8_t)); pInfo != nullptr)
     {
-        const auto location = ConvertToIoLocation(address);
-        return location.pIo->Read(pOutBuffer, size, location.offset);
+        pInfo->pIo->Read(pOutBuffer, size, static_cast<int>(address - pInfo->address));
     }
     else
     {
@@ -41,15 +48,14 @@ void Bus::Read(void* pOutBuffer, size_t size, paddr_t address)
 
 void Bus::Write(const void* pBuffer, size_t size, paddr_t address)
 {
-    if (IsMemoryAddress(address, sizeof(int8_t)))
+    if (const auto pInfo = FindMemory(address, sizeof(int8_t)); pInfo != nullptr)
     {
-        const auto location = ConvertToMemoryLocation(address);
-        location.pMemory->Write(pBuffer, size, location.offset);
+        pInfo->pMemory->Write(pBuffer, size, address - pInfo->address);
+        NotifyMemoryWrite(address, size);
     }
-    else if (IsIoAddress(address, sizeof(int8_t)))
+    else if (const auto pInfo = FindIo(address, sizeof(int8_t)); pInfo != nullptr)
     {
-        const auto location = ConvertToIoLocation(address);
-        location.pIo->Write(pBuffer, size, location.offset);
+        pInfo->pIo->Write(pBuffer, size, static_cast<int>(address - pInfo->address));
     }
     else
     {
@@ -57,68 +63,131 @@ void Bus::Write(const void* pBuffer, size_t size, paddr_t address)
     }
 }
 
-uint8_t Bus::ReadUInt8(paddr_t address)
+template <typename T>
+T Bus::ReadValue(paddr_t address)
 {
-    int8_t value;
-    Read(&value, sizeof(value), address);
+    T value;
+
+    const auto pInfo = FindMemory(address, sizeof(T));
+    if (pInfo != nullptr && pInfo->pHostRead != nullptr)
+    {
+        std::memcpy(&value, &pInfo->pHostRead[address - pInfo->address], sizeof(T));
+    }
+    else
+    {
+        Read(&value, sizeof(T), address);
+    }
 
     return value;
 }
 
-uint16_t Bus::ReadUInt16(paddr_t address)
+template <typename T>
+void Bus::WriteValue(paddr_t address, T value)
 {
-    int16_t value;
-    Read(&value, sizeof(value), address);
+    const auto pInfo = FindMemory(address, sizeof(T));
+    if (pInfo != nullptr && pInfo->pHostWrite != nullptr)
+    {
+        const auto offset = address - pInfo->address;
 
-    return value;
+        std::memcpy(&pInfo->pHostWrite[offset], &value, sizeof(T));
+
+        if (pInfo->pDirtyPageMap != nullptr)
+        {
+            pInfo->pDirtyPageMap[offset >> mem::IMemory::PageShift] = 1;
+            pInfo->pDirtyPageMap[(offset + sizeof(T) - 1) >> mem::IMemory::PageShift] = 1;
+        }
+
+        NotifyMemoryWrite(address, sizeof(T));
+    }
+    else
+    {
+        Write(&value, sizeof(T), address);
+    }
 }
 
-uint32_t Bus::ReadUInt32(paddr_t address)
+uint8_t Bus::ReadUInt8(paddr_t address)
 {
-    uint32_t value;
-    Read(&value, sizeof(value), address);
+    return ReadValue<uint8_t>(address);
+}
 
-    return value;
+uint16_t Bus::ReadUInt16(paddr_t address)
+{
+    return ReadValue<uint16_t>(address);
 }
 
-uint64_t Bus::ReadUInt64(paddr_t address)
+uint32_t Bus::ReadUInt32(paddr_t address)
 {
-    int64_t value;
-    Read(&value, sizeof(value), address);
+    return ReadValue<uint32_t>(address);
+}
 
-    return value;
+uint64_t Bus::ReadUInt64(paddr_t address)
+{
+    return ReadValue<uint64_t>(address);
 }
 
 void Bus::WriteUInt8(paddr_t address, uint8_t value)
 {
-    Write(&value, sizeof(value), address);
+    WriteValue(address, value);
 }
 
 void Bus::WriteUInt16(paddr_t address, uint16_t value)
 {
-    Write(&value, sizeof(value), address);
+    WriteValue(address, value);
 }
 
 void Bus::WriteUInt32(paddr_t address, uint32_t value)
 {
-    Write(&value, sizeof(value), address);
+    WriteValue(address, value);
 }
 
 void Bus::WriteUInt64(paddr_t address, uint64_t value)
 {
-    Write(&value, sizeof(value), address);
+    WriteValue(address, value);
 }
 
 void Bus::RegisterMemory(mem::IMemory* pMemory, paddr_t address, size_t size)
 {
-    MemoryInfo info { pMemory, address, size };
+    MemoryInfo info
+    {
+        pMemory,
+        address,
+        size,
+        static_cast<const char*>(pMemory->GetReadPointer()),
+        static_cast<char*>(pMemory->GetWritePointer()),
+        pMemory->GetDirtyPageMap(),
+    };
     m_MemoryList.push_back(info);
+
+    RegisterDecodeEntry(DecodeType::Memory, m_MemoryList.size() - 1, address, size);
 }
 
 void Bus::RegisterIo(io::IIo* pIo, paddr_t address, size_t size)
 {
     IoInfo info { pIo, address, size };
     m_IoList.push_back(info);
+
+    RegisterDecodeEntry(DecodeType::Io, m_IoList.size() - 1, address, size);
+}
+
+void Bus::RegisterObserver(IBusObserver* pObserver)
+{
+    m_ObserverList.push_back(pObserver);
+}
+
+void Bus::SetWatchRange(paddr_t address, size_t size)
+{
+    m_WatchAddress = address;
+    m_WatchSize = size;
+}
+
+bool Bus::IsWatchRangeWritten() const
+{
+    return m_WatchRangeWritten;
+}
+
+void Bus::ClearWatchRangeWritten()
+{
+    m_WatchRangeWritten = false;
 }
 
 bool Bus::IsValidAddress(paddr_t address, size_t accessSize) const
@@ -128,70 +197,161 @@ bool Bus::IsValidAddress(paddr_t address, size_t accessSize) const
 
 bool Bus::IsMemoryAddress(paddr_t address, size_t accessSize) const
 {
-    const auto low = address;
-    const auto high = address + accessSize - 1;
+    return FindMemory(address, accessSize) != nullptr;
+}
 
-    for (const auto& location: m_MemoryList)
+bool Bus::IsIoAddress(paddr_t address, size_t accessSize) const
+{
+    return FindIo(address, accessSize) != nullptr;
+}
+
+MemoryLocation Bus::ConvertToMemoryLocation(paddr_t address) const
+{
+    const auto pInfo = FindMemory(address, sizeof(uint8_t));
+    if (pInfo == nullptr)
     {
-        if (location.address <= low && high < location.address + location.size)
+        RAFI_EMU_ERROR("Invalid addresss: 0x%016" PRIx64 "\n", address);
+    }
+
+    MemoryLocation ret;
+
+    ret.pMemory = pInfo->pMemory;
+    ret.offset = static_cast<int>(address - pInfo->address);
+
+    return ret;
+}
+
+IoLocation Bus::ConvertToIoLocation(paddr_t address) const
+{
+    const auto pInfo = FindIo(address, sizeof(uint8_t));
+    if (pInfo == nullptr)
+    {
+        RAFI_EMU_ERROR("Invalid addresss: 0x%016" PRIx64 "\n", address);
+    }
+
+    IoLocation ret;
+
+    ret.pIo = pInfo->pIo;
+    ret.offset = static_cast<int>(address - pInfo->address);
+
+    return ret;
+}
+
+void Bus::RegisterDecodeEntry(DecodeType type, size_t index, paddr_t address, size_t size)
+{
+    if (size == 0)
+    {
+        return;
+    }
+    if (index >= MaxRegionCount)
+    {
+        RAFI_EMU_ERROR("Too many regions are registered to bus.\n");
+    }
+
+    const auto lastPage = (address + size - 1) >> PageShift;
+    if ((lastPage >> (ChunkShift - PageShift)) >= MaxChunkCount)
+    {
+        RAFI_EMU_ERROR("Region is too high to register to bus: 0x%016" PRIx64 "\n", address);
+    }
+
+    for (auto page = address >> PageShift; page <= lastPage; page++)
+    {
+        const auto chunk = static_cast<size_t>(page >> (ChunkShift - PageShift));
+        if (chunk >= m_DecodeTable.size())
+        {
+            m_DecodeTable.resize(chunk + 1);
+        }
+        if (m_DecodeTable[chunk].empty())
         {
-            return true;
+            m_DecodeTable[chunk].resize(PageCountPerChunk, DecodeEntry { DecodeType::None, 0 });
+        }
+
+        auto& entry = m_DecodeTable[chunk][page % PageCountPerChunk];
+        if (entry.type == DecodeType::None)
+        {
+            entry = DecodeEntry { type, static_cast<uint8_t>(index) };
+        }
+        else
+        {
+            entry.type = DecodeType::Multiple;
         }
     }
+}
+
+DecodeEntry Bus::GetDecodeEntry(paddr_t address) const
+{
+    const auto page = address >> PageShift;
+    const auto chunk = page >> (ChunkShift - PageShift);
 
-    return false;
+    if (chunk >= m_DecodeTable.size() || m_DecodeTable[chunk].empty())
+    {
+        return DecodeEntry { DecodeType::None, 0 };
+    }
+
+    return m_DecodeTable[chunk][page % PageCountPerChunk];
 }
 
-bool Bus::IsIoAddress(paddr_t address, size_t accessSize) const
+const MemoryInfo* Bus::FindMemory(paddr_t address, size_t accessSize) const
 {
     const auto low = address;
     const auto high = address + accessSize - 1;
 
-    for (const auto& location: m_IoList)
+    const auto entry = GetDecodeEntry(address);
+    if (entry.type == DecodeType::Memory)
     {
-        if (location.address <= low && high < location.address + location.size)
+        const auto& info = m_MemoryList[entry.index];
+        return info.address <= low && high < info.address + info.size ? &info : nullptr;
+    }
+    else if (entry.type == DecodeType::Multiple)
+    {
+        for (const auto& info: m_MemoryList)
         {
-            return true;
+            if (info.address <= low && high < info.address + info.size)
+            {
+                return &info;
+            }
         }
     }
 
-    return false;
+    return nullptr;
 }
 
-MemoryLocation Bus::ConvertToMemoryLocation(paddr_t address) const
+const IoInfo* Bus::FindIo(paddr_t address, size_t accessSize) const
 {
-    for (const auto& location: m_MemoryList)
+    const auto low = address;
+    const auto high = address + accessSize - 1;
+
+    const auto entry = GetDecodeEntry(address);
+    if (entry.type == DecodeType::Io)
     {
-        if (location.address <= address && address < location.address + location.size)
+        const auto& info = m_IoList[entry.index];
+        return info.address <= low && high < info.address + info.size ? &info : nullptr;
+    }
+    else if (entry.type == DecodeType::Multiple)
+    {
+        for (const auto& info: m_IoList)
         {
-            MemoryLocation ret;
-
-            ret.pMemory = location.pMemory;
-            ret.offset = static_cast<int>(address - location.address);
-
-            return ret;
+            if (info.address <= low && high < info.address + info.size)
+            {
+                return &info;
+            }
         }
     }
 
-    RAFI_EMU_ERROR("Invalid addresss: 0x%016" PRIx64 "\n", address);
+    return nullptr;
 }
 
-IoLocation Bus::ConvertToIoLocation(paddr_t address) const
+void Bus::NotifyMemoryWrite(paddr_t address, size_t size)
 {
-    for (const auto& location: m_IoList)
+    if (m_WatchSize > 0 && address <= m_WatchAddress + m_WatchSize - 1 && m_WatchAddress <= address + size - 1)
     {
-        if (location.address <= address && address < location.address + location.size)
-        {
-            IoLocation ret;
-
-            ret.pIo = location.pIo;
-            ret.offset = static_cast<int>(address - location.address);
-
-            return ret;
-        }
+        m_WatchRangeWritten = true;
     }
 
-    RAFI_EMU_ERROR("Invalid addresss: 0x%016" PRIx64 "\n", address);
+    for (auto pObserver: m_ObserverList)
+    {
+        pObserver->OnMemoryWrite(address, size);
+    }
 }
 
 }}}
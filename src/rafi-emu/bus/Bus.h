@@ -24,6 +24,8 @@
 #include "../io/IIo.h"
 #include "../mem/IMemory.h"
 
+#include "IBusObserver.h"
+
 namespace rafi { namespace emu { namespace bus {
 
 struct MemoryInfo
@@ -31,6 +33,13 @@ struct MemoryInfo
     mem::IMemory* pMemory;
     paddr_t address;
     size_t size;
+
+    // for direct access to host memory (nullptr if not available)
+    const char* pHostRead;
+    char* pHostWrite;
+
+    // for writes via pHostWrite (nullptr if not tracked)
+    uint8_t* pDirtyPageMap;
 };
 
 struct IoInfo
@@ -40,6 +49,20 @@ struct IoInfo
     size_t size;
 };
 
+enum class DecodeType : uint8_t
+{
+    None,
+    Memory,
+    Io,
+    Multiple, // the page is shared by some regions
+};
+
+struct DecodeEntry
+{
+    DecodeType type;
+    uint8_t index;
+};
+
 struct MemoryLocation
 {
     mem::IMemory* pMemory;
@@ -70,6 +93,12 @@ public:
 
     void RegisterMemory(mem::IMemory* pMemory, paddr_t address, size_t size);
     void RegisterIo(io::IIo* pIo, paddr_t address, size_t size);
+    void RegisterObserver(IBusObserver* pObserver);
+
+    // Records whether memory in the range is written (e.g. host io). Checked without calling observers.
+    void SetWatchRange(paddr_t address, size_t size);
+    bool IsWatchRangeWritten() const;
+    void ClearWatchRangeWritten();
 
     bool IsValidAddress(paddr_t address, size_t accessSize) const;
     bool IsMemoryAddress(paddr_t address, size_t accessSize) const;
@@ -79,8 +108,35 @@ public:
     IoLocation ConvertToIoLocation(paddr_t address) const;
 
 private:
+    static const int PageShift = 12;
+    static const int ChunkShift = 30;
+    static const size_t PageCountPerChunk = static_cast<size_t>(1) << (ChunkShift - PageShift);
+    static const size_t MaxChunkCount = 1 << 16;
+    static const size_t MaxRegionCount = 256;
+
+    void RegisterDecodeEntry(DecodeType type, size_t index, paddr_t address, size_t size);
+    DecodeEntry GetDecodeEntry(paddr_t address) const;
+
+    const MemoryInfo* FindMemory(paddr_t address, size_t accessSize) const;
+    const IoInfo* FindIo(paddr_t address, size_t accessSize) const;
+    void NotifyMemoryWrite(paddr_t address, size_t size);
+
+    template <typename T>
+    T ReadValue(paddr_t address);
+
+    template <typename T>
+    void WriteValue(paddr_t address, T value);
+
     std::vector<MemoryInfo> m_MemoryList;
     std::vector<IoInfo> m_IoList;
+    std::vector<IBusObserver*> m_ObserverList;
+
+    paddr_t m_WatchAddress{ 0 };
+    size_t m_WatchSize{ 0 };
+    bool m_WatchRangeWritten{ false };
+
+    // Page-granular table to find a region in O(1); chunks without regions are left empty.
+    std::vector<std::vector<DecodeEntry>> m_DecodeTable;
 };
 
 }}}
@@ -41,4 +41,16 @@ void AtomicManager::Cancel()
     m_Reserved = false;
 }
 
+void AtomicManager::SaveState(SnapshotWriter* pWriter) const
+{
+    pWriter->Write(m_Address);
+    pWriter->Write(m_Reserved);
+}
+
+void AtomicManager::LoadState(SnapshotReader* pReader)
+{
+    pReader->Read(&m_Address);
+    pReader->Read(&m_Reserved);
+}
+
 }}}
@@ -18,6 +18,8 @@
 
 #include <rafi/emu.h>
 
+#include "../Snapshot.h"
+
 namespace rafi { namespace emu { namespace cpu {
 
 class AtomicManager
@@ -30,6 +32,10 @@ public:
     void Reserve(vaddr_t addr);
 
     void Cancel();
+
+    void SaveState(SnapshotWriter* pWriter) const;
+    void LoadState(SnapshotReader* pReader);
+
 private:
     vaddr_t m_Address{0};
     bool m_Reserved{false};
@@ -0,0 +1,162 @@
+/*
+ * Copyright 2018 Akifumi Fujita
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <rafi/emu.h>
+
+#include "BasicBlockCache.h"
+#include "DecodeCache.h"
+
+namespace rafi { namespace emu { namespace cpu {
+
+void BasicBlockCache::Initialize(bus::Bus* pBus, Decoder* pDecoder, Executor* pExecutor)
+{
+    m_pBus = pBus;
+    m_pDecoder = pDecoder;
+    m_pExecutor = pExecutor;
+}
+
+BasicBlock* BasicBlockCache::Get(paddr_t address)
+{
+    const auto it = m_Blocks.find(address);
+    if (it != m_Blocks.end())
+    {
+        return it->second.get();
+    }
+
+    auto block = Build(address);
+    if (block->ops.empty())
+    {
+        return nullptr;
+    }
+
+    auto pBlock = block.get();
+
+    m_PageBlocks[address / PageSize].push_back(address);
+    m_Blocks.emplace(address, std::move(block));
+
+    return pBlock;
+}
+
+void BasicBlockCache::Invalidate(paddr_t address, size_t size)
+{
+    if (m_PageBlocks.empty() || size == 0)
+    {
+        return;
+    }
+
+    // Each block is in a single page, so only blocks in the written pages are stale.
+    for (auto pageNumber = address / PageSize; pageNumber <= (address + size - 1) / PageSize; pageNumber++)
+    {
+        const auto it = m_PageBlocks.find(pageNumber);
+        if (it == m_PageBlocks.end())
+        {
+            continue;
+        }
+
+        for (const auto blockAddress: it->second)
+        {
+            m_Blocks.erase(blockAddress);
+        }
+
+        m_PageBlocks.erase(it);
+        m_Generation++;
+    }
+}
+
+void BasicBlockCache::InvalidateAll()
+{
+    m_Blocks.clear();
+    m_PageBlocks.clear();
+    m_Generation++;
+}
+
+void BasicBlockCache::OnMemoryWrite(paddr_t address, size_t size)
+{
+    Invalidate(address, size);
+}
+
+uint64_t BasicBlockCache::GetGeneration() const
+{
+    return m_Generation;
+}
+
+std::unique_ptr<BasicBlock> BasicBlockCache::Build(paddr_t address)
+{
+    auto block = std::make_unique<BasicBlock>();
+    block->physicalPc = address;
+
+    // Ops are fetched without memory access events, which are recorded when each op is processed.
+    for (auto current = address; DecodeCache::IsCacheable(current) && m_pBus->IsMemoryAddress(current, sizeof(uint32_t)); )
+    {
+        const auto insn = m_pBus->ReadUInt32(current);
+        const auto op = m_pDecoder->Decode(insn);
+        const int size = m_pDecoder->IsCompressedInstruction(insn) ? 2 : 4;
+
+        block->ops.push_back({ op, m_pExecutor->GetHandler(op), insn, size, JitRun() });
+
+        if (IsBasicBlockEnd(op))
+        {
+            break;
+        }
+
+        current += size;
+    }
+
+    return block;
+}
+
+bool BasicBlockCache::IsBasicBlockEnd(const Op& op) const
+{
+    switch (op.opCode)
+    {
+    case OpCode::unknown:
+    case OpCode::jal:
+    case OpCode::jalr:
+    case OpCode::beq:
+    case OpCode::bne:
+    case OpCode::blt:
+    case OpCode::bge:
+    case OpCode::bltu:
+    case OpCode::bgeu:
+    case OpCode::c_j:
+    case OpCode::c_jal:
+    case OpCode::c_jr:
+    case OpCode::c_jalr:
+    case OpCode::c_beqz:
+    case OpCode::c_bnez:
+    case OpCode::c_ebreak:
+    case OpCode::ecall:
+    case OpCode::ebreak:
+    case OpCode::mret:
+    case OpCode::sret:
+    case OpCode::uret:
+    case OpCode::wfi:
+    case OpCode::fence:
+    case OpCode::fence_i:
+    case OpCode::sfence_vma:
+    case OpCode::csrrw:
+    case OpCode::csrrs:
+    case OpCode::csrrc:
+    case OpCode::csrrwi:
+    case OpCode::csrrsi:
+    case OpCode::csrrci:
+        return true;
+    default:
+        return false;
+    }
+}
+
+}}}
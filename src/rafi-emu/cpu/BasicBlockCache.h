@@ -0,0 +1,92 @@
+/*
+ * Copyright 2018 Akifumi Fujita
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include <rafi/common.h>
+#include <rafi/emu.h>
+
+#include "../bus/Bus.h"
+#include "../bus/IBusObserver.h"
+
+#include "Executor.h"
+#include "JitCompiler.h"
+
+namespace rafi { namespace emu { namespace cpu {
+
+struct BasicBlockOp
+{
+    Op op;
+    Executor::Handler handler;
+    uint32_t insn;
+    int size;
+
+    // Valid if this op begins a compiled run.
+    JitRun jitRun;
+};
+
+// Straight-line ops in a physical page.
+// A basic block ends at a branch, a jump, a csr op, a system op (which may trap or change translation) or the end of a page.
+struct BasicBlock
+{
+    paddr_t physicalPc;
+    std::vector<BasicBlockOp> ops;
+
+    // for jit
+    int executionCount{ 0 };
+    bool compiled{ false };
+};
+
+class BasicBlockCache final : public bus::IBusObserver
+{
+public:
+    void Initialize(bus::Bus* pBus, Decoder* pDecoder, Executor* pExecutor);
+
+    // Returns nullptr if no op can be cached at the address.
+    BasicBlock* Get(paddr_t address);
+
+    void Invalidate(paddr_t address, size_t size);
+    void InvalidateAll();
+
+    void OnMemoryWrite(paddr_t address, size_t size) override;
+
+    // Incremented when cached blocks are discarded. Blocks got before that must not be used.
+    uint64_t GetGeneration() const;
+
+private:
+    static const int PageSize = 0x1000;
+
+    std::unique_ptr<BasicBlock> Build(paddr_t address);
+
+    bool IsBasicBlockEnd(const Op& op) const;
+
+    bus::Bus* m_pBus{ nullptr };
+    Decoder* m_pDecoder{ nullptr };
+    Executor* m_pExecutor{ nullptr };
+
+    std::unordered_map<paddr_t, std::unique_ptr<BasicBlock>> m_Blocks;
+
+    // page number -> physical pc of blocks in the page
+    std::unordered_map<paddr_t, std::vector<paddr_t>> m_PageBlocks;
+
+    uint64_t m_Generation{ 0 };
+};
+
+}}}
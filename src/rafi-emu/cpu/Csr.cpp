@@ -129,18 +129,24 @@ Csr::Csr(XLEN xlen, vaddr_t initialPc)
          .SetMember<misa_t::U>(1)   // Present User-mode
          .SetMember<misa_t::S>(1);  // Present Supervisor-mode
 
+    xstatus_t sd(0);
+
     switch (m_XLEN)
     {
     case XLEN::XLEN32:
         m_ISA.SetMember<misa_t::MXL_RV32>(static_cast<uint32_t>(XLEN::XLEN32));
+        sd.SetMember<xstatus_t::SD_RV32>(1ull);
         break;
     case XLEN::XLEN64:
         m_ISA.SetMember<misa_t::MXL_RV64>(static_cast<uint32_t>(XLEN::XLEN64));
+        sd.SetMember<xstatus_t::SD_RV64>(1ull);
         break;
     default:
         RAFI_EMU_NOT_IMPLEMENTED;
     }
 
+    m_StatusSdMask = sd.GetValue();
+
     // Disable SXL and UXL bit for qemu-compatibility.
     // m_Status.SetMember<xstatus_t::SXL>(static_cast<uint32_t>(m_XLEN));
     // m_Status.SetMember<xstatus_t::UXL>(static_cast<uint32_t>(m_XLEN));
@@ -164,13 +170,7 @@ PrivilegeLevel Csr::GetPrivilegeLevel() const
 void Csr::SetPrivilegeLevel(PrivilegeLevel level)
 {
     m_PrivilegeLevel = level;
-}
-
-void Csr::ProcessCycle()
-{
-    m_CycleCounter++;
-    m_TimeCounter++;
-    m_InstructionRetiredCounter++;
+    m_InterruptGeneration++;
 }
 
 std::optional<Trap> Csr::CheckTrap(csr_addr_t addr, bool write, vaddr_t pc, uint32_t insn) const
@@ -246,18 +246,32 @@ uint32_t Csr::ReadUInt32(csr_addr_t addr) const
 }
 
 uint64_t Csr::ReadUInt64(csr_addr_t addr) const
+{
+    switch (m_XLEN)
+    {
+    case XLEN::XLEN32:
+        return ReadRegister<XLEN::XLEN32>(addr);
+    case XLEN::XLEN64:
+        return ReadRegister<XLEN::XLEN64>(addr);
+    default:
+        RAFI_EMU_NOT_IMPLEMENTED;
+    }
+}
+
+template <XLEN xlen>
+uint64_t Csr::ReadRegister(csr_addr_t addr) const
 {
     if (IsMachineModeRegister(addr))
     {
-        return ReadMachineModeRegister(addr);
+        return ReadMachineModeRegister<xlen>(addr);
     }
     else if (IsSupervisorModeRegister(addr))
     {
-        return ReadSupervisorModeRegister(addr);
+        return ReadSupervisorModeRegister<xlen>(addr);
     }
     else if (IsUserModeRegister(addr))
     {
-        return ReadUserModeRegister(addr);
+        return ReadUserModeRegister<xlen>(addr);
     }
     else
     {
@@ -272,18 +286,34 @@ void Csr::WriteUInt32(csr_addr_t addr, uint32_t value)
 }
 
 void Csr::WriteUInt64(csr_addr_t addr, uint64_t value)
+{
+    switch (m_XLEN)
+    {
+    case XLEN::XLEN32:
+        WriteRegister<XLEN::XLEN32>(addr, value);
+        break;
+    case XLEN::XLEN64:
+        WriteRegister<XLEN::XLEN64>(addr, value);
+        break;
+    default:
+        RAFI_EMU_NOT_IMPLEMENTED;
+    }
+}
+
+template <XLEN xlen>
+void Csr::WriteRegister(csr_addr_t addr, uint64_t value)
 {
     if (IsMachineModeRegister(addr))
     {
-        WriteMachineModeRegister(addr, value);
+        WriteMachineModeRegister<xlen>(addr, value);
     }
     else if (IsSupervisorModeRegister(addr))
     {
-        WriteSupervisorModeRegister(addr, value);
+        WriteSupervisorModeRegister<xlen>(addr, value);
     }
     else if (IsUserModeRegister(addr))
     {
-        WriteUserModeRegister(addr, value);
+        WriteUserModeRegister<xlen>(addr, value);
     }
     else
     {
@@ -313,17 +343,7 @@ xstatus_t Csr::ReadStatus() const
 
     if (status.GetMember<xstatus_t::XS>() == 0b11 || status.GetMember<xstatus_t::FS>() == 0b11)
     {
-        switch (m_XLEN)
-        {
-            case XLEN::XLEN32:
-                status.SetMember<xstatus_t::SD_RV32>(1ull);
-                break;
-            case XLEN::XLEN64:
-                status.SetMember<xstatus_t::SD_RV64>(1ull);
-                break;
-            default:
-                RAFI_EMU_NOT_IMPLEMENTED;
-        }
+        status.SetValue(status.GetValue() | m_StatusSdMask);
     }
 
     return status;
@@ -336,7 +356,17 @@ satp_t Csr::ReadSatp() const
 
 uint64_t Csr::ReadTime() const
 {
-    return m_TimeCounter;
+    return GetTimeCounter();
+}
+
+uint64_t Csr::GetTranslationGeneration() const
+{
+    return m_TranslationGeneration;
+}
+
+uint64_t Csr::GetInterruptGeneration() const
+{
+    return m_InterruptGeneration;
 }
 
 void Csr::WriteFpCsr(const fcsr_t& value)
@@ -347,16 +377,28 @@ void Csr::WriteFpCsr(const fcsr_t& value)
 void Csr::WriteInterruptPending(const xip_t& value)
 {
     m_InterruptPending = value;
+    m_InterruptGeneration++;
 }
 
 void Csr::WriteStatus(const xstatus_t& value)
 {
+    const auto prev = m_Status;
+
     m_Status.SetWithMask(value, xstatus_t::WriteMask);
+    m_InterruptGeneration++;
+
+    if (prev.GetMember<xstatus_t::MPRV>() != m_Status.GetMember<xstatus_t::MPRV>() ||
+        prev.GetMember<xstatus_t::SUM>() != m_Status.GetMember<xstatus_t::SUM>() ||
+        prev.GetMember<xstatus_t::MXR>() != m_Status.GetMember<xstatus_t::MXR>())
+    {
+        m_TranslationGeneration++;
+    }
 }
 
 void Csr::WriteTime(uint64_t value)
 {
-    m_TimeCounter = value;
+    SetTimeCounter(value);
+    m_InterruptGeneration++;
 }
 
 bool Csr::IsUserModeRegister(csr_addr_t addr) const
@@ -379,6 +421,7 @@ bool Csr::IsMachineModeRegister(csr_addr_t addr) const
     return ((static_cast<uint32_t>(addr) >> 8) & 0b11) == 0b11;
 }
 
+template <XLEN xlen>
 uint64_t Csr::ReadMachineModeRegister(csr_addr_t addr) const
 {
     if (csr_addr_t::pmpaddr_begin <= addr && addr < csr_addr_t::pmpaddr_end)
@@ -428,29 +471,29 @@ uint64_t Csr::ReadMachineModeRegister(csr_addr_t addr) const
     case csr_addr_t::mhartid:
         return 0;
     default:
-        if (addr == csr_addr_t::mcycle && m_XLEN == XLEN::XLEN32)
+        if (addr == csr_addr_t::mcycle && xlen == XLEN::XLEN32)
         {
-            return GetLow32(m_CycleCounter);
+            return GetLow32(GetCycleCounter());
         }
-        else if (addr == csr_addr_t::mcycle && m_XLEN == XLEN::XLEN64)
+        else if (addr == csr_addr_t::mcycle && xlen == XLEN::XLEN64)
         {
-            return m_CycleCounter;
+            return GetCycleCounter();
         }
-        else if (addr == csr_addr_t::minstret && m_XLEN == XLEN::XLEN32)
+        else if (addr == csr_addr_t::minstret && xlen == XLEN::XLEN32)
         {
-            return GetLow32(m_InstructionRetiredCounter);
+            return GetLow32(GetInstructionRetiredCounter());
         }
-        else if (addr == csr_addr_t::minstret && m_XLEN == XLEN::XLEN64)
+        else if (addr == csr_addr_t::minstret && xlen == XLEN::XLEN64)
         {
-            return m_InstructionRetiredCounter;
+            return GetInstructionRetiredCounter();
         }
-        else if (addr == csr_addr_t::mcycleh && m_XLEN == XLEN::XLEN32)
+        else if (addr == csr_addr_t::mcycleh && xlen == XLEN::XLEN32)
         {
-            return GetHigh32(m_CycleCounter);
+            return GetHigh32(GetCycleCounter());
         }
-        else if (addr == csr_addr_t::minstreth && m_XLEN == XLEN::XLEN32)
+        else if (addr == csr_addr_t::minstreth && xlen == XLEN::XLEN32)
         {
-            return GetHigh32(m_InstructionRetiredCounter);
+            return GetHigh32(GetInstructionRetiredCounter());
         }
         else
         {
@@ -460,16 +503,17 @@ uint64_t Csr::ReadMachineModeRegister(csr_addr_t addr) const
     }
 }
 
+template <XLEN xlen>
 uint64_t Csr::ReadSupervisorModeRegister(csr_addr_t addr) const
 {
     switch (addr)
     {
     case csr_addr_t::sstatus:
-        if (m_XLEN == XLEN::XLEN32)
+        if (xlen == XLEN::XLEN32)
         {
             return ReadStatus().GetWithMask(xstatus_t::SupervisorMask_RV32);
         }
-        else if (m_XLEN == XLEN::XLEN64)
+        else if (xlen == XLEN::XLEN64)
         {
             return ReadStatus().GetWithMask(xstatus_t::SupervisorMask_RV64);
         }
@@ -505,6 +549,7 @@ uint64_t Csr::ReadSupervisorModeRegister(csr_addr_t addr) const
     }
 }
 
+template <XLEN xlen>
 uint64_t Csr::ReadUserModeRegister(csr_addr_t addr) const
 {
     switch (addr)
@@ -532,41 +577,41 @@ uint64_t Csr::ReadUserModeRegister(csr_addr_t addr) const
     case csr_addr_t::uip:
         return m_InterruptPending.GetWithMask(xip_t::UserMask);
     default:
-        if (addr == csr_addr_t::cycle && m_XLEN == XLEN::XLEN32)
+        if (addr == csr_addr_t::cycle && xlen == XLEN::XLEN32)
         {
-            return GetLow32(m_CycleCounter);
+            return GetLow32(GetCycleCounter());
         }
-        else if (addr == csr_addr_t::cycle && m_XLEN == XLEN::XLEN64)
+        else if (addr == csr_addr_t::cycle && xlen == XLEN::XLEN64)
         {
-            return m_CycleCounter;
+            return GetCycleCounter();
         }
-        else if (addr == csr_addr_t::time && m_XLEN == XLEN::XLEN32)
+        else if (addr == csr_addr_t::time && xlen == XLEN::XLEN32)
         {
-            return GetLow32(m_CycleCounter);
+            return GetLow32(GetCycleCounter());
         }
-        else if (addr == csr_addr_t::time && m_XLEN == XLEN::XLEN64)
+        else if (addr == csr_addr_t::time && xlen == XLEN::XLEN64)
         {
-            return m_TimeCounter;
+            return GetTimeCounter();
         }
-        else if (addr == csr_addr_t::instret && m_XLEN == XLEN::XLEN32)
+        else if (addr == csr_addr_t::instret && xlen == XLEN::XLEN32)
         {
-            return GetLow32(m_InstructionRetiredCounter);
+            return GetLow32(GetInstructionRetiredCounter());
         }
-        else if (addr == csr_addr_t::instret && m_XLEN == XLEN::XLEN64)
+        else if (addr == csr_addr_t::instret && xlen == XLEN::XLEN64)
         {
-            return m_InstructionRetiredCounter;
+            return GetInstructionRetiredCounter();
         }
-        else if (addr == csr_addr_t::cycleh && m_XLEN == XLEN::XLEN32)
+        else if (addr == csr_addr_t::cycleh && xlen == XLEN::XLEN32)
         {
-            return GetHigh32(m_CycleCounter);
+            return GetHigh32(GetCycleCounter());
         }
-        else if (addr == csr_addr_t::timeh && m_XLEN == XLEN::XLEN32)
+        else if (addr == csr_addr_t::timeh && xlen == XLEN::XLEN32)
         {
-            return GetHigh32(m_TimeCounter);
+            return GetHigh32(GetTimeCounter());
         }
-        else if (addr == csr_addr_t::instreth && m_XLEN == XLEN::XLEN32)
+        else if (addr == csr_addr_t::instreth && xlen == XLEN::XLEN32)
         {
-            return GetHigh32(m_InstructionRetiredCounter);
+            return GetHigh32(GetInstructionRetiredCounter());
         }
         else
         {
@@ -576,6 +621,7 @@ uint64_t Csr::ReadUserModeRegister(csr_addr_t addr) const
 	}
 }
 
+template <XLEN xlen>
 void Csr::WriteMachineModeRegister(csr_addr_t addr, uint64_t value)
 {
     if (csr_addr_t::pmpaddr_begin <= addr && addr < csr_addr_t::pmpaddr_end)
@@ -598,9 +644,11 @@ void Csr::WriteMachineModeRegister(csr_addr_t addr, uint64_t value)
         return;
     case csr_addr_t::mideleg:
         m_MachineInterruptDelegation = value;
+        m_InterruptGeneration++;
         return;
     case csr_addr_t::mie:
         m_InterruptEnable.SetWithMask(value, xie_t::MachineMask);
+        m_InterruptGeneration++;
         return;
     case csr_addr_t::mcounteren:
         m_MachineCounterEnable = value;
@@ -622,6 +670,7 @@ void Csr::WriteMachineModeRegister(csr_addr_t addr, uint64_t value)
         return;
     case csr_addr_t::mip:
         m_InterruptPending.SetWithMask(value, xip_t::MachineMask & xip_t::WriteMask);
+        m_InterruptGeneration++;
         return;
     case csr_addr_t::pmpcfg0:
     case csr_addr_t::pmpcfg1:
@@ -630,29 +679,37 @@ void Csr::WriteMachineModeRegister(csr_addr_t addr, uint64_t value)
         // TODO: Implement PMP
         return;
     default:
-        if (addr == csr_addr_t::mcycle && m_XLEN == XLEN::XLEN32)
+        if (addr == csr_addr_t::mcycle && xlen == XLEN::XLEN32)
         {
-            SetLow32(&m_CycleCounter, value);
+            auto counter = GetCycleCounter();
+            SetLow32(&counter, value);
+            SetCycleCounter(counter);
         }
-        else if (addr == csr_addr_t::mcycle && m_XLEN == XLEN::XLEN64)
+        else if (addr == csr_addr_t::mcycle && xlen == XLEN::XLEN64)
         {
-            m_CycleCounter = value;
+            SetCycleCounter(value);
         }
-        else if (addr == csr_addr_t::minstret && m_XLEN == XLEN::XLEN32)
+        else if (addr == csr_addr_t::minstret && xlen == XLEN::XLEN32)
         {
-            SetLow32(&m_InstructionRetiredCounter, value);
+            auto counter = GetInstructionRetiredCounter();
+            SetLow32(&counter, value);
+            SetInstructionRetiredCounter(counter);
         }
-        else if (addr == csr_addr_t::minstret && m_XLEN == XLEN::XLEN64)
+        else if (addr == csr_addr_t::minstret && xlen == XLEN::XLEN64)
         {
-            m_InstructionRetiredCounter = value;
+            SetInstructionRetiredCounter(value);
         }
-        else if (addr == csr_addr_t::mcycleh && m_XLEN == XLEN::XLEN32)
+        else if (addr == csr_addr_t::mcycleh && xlen == XLEN::XLEN32)
         {
-            SetHigh32(&m_CycleCounter, value);
+            auto counter = GetCycleCounter();
+            SetHigh32(&counter, value);
+            SetCycleCounter(counter);
         }
-        else if (addr == csr_addr_t::minstreth && m_XLEN == XLEN::XLEN32)
+        else if (addr == csr_addr_t::minstreth && xlen == XLEN::XLEN32)
         {
-            SetHigh32(&m_InstructionRetiredCounter, value);
+            auto counter = GetInstructionRetiredCounter();
+            SetHigh32(&counter, value);
+            SetInstructionRetiredCounter(counter);
         }
         else
         {
@@ -662,12 +719,13 @@ void Csr::WriteMachineModeRegister(csr_addr_t addr, uint64_t value)
     }
 }
 
+template <XLEN xlen>
 void Csr::WriteSupervisorModeRegister(csr_addr_t addr, uint64_t value)
 {
     switch(addr)
     {
     case csr_addr_t::sstatus:
-        switch (m_XLEN)
+        switch (xlen)
         {
             case XLEN::XLEN32:
                 WriteStatus(value & xstatus_t::SupervisorMask_RV32);
@@ -683,9 +741,11 @@ void Csr::WriteSupervisorModeRegister(csr_addr_t addr, uint64_t value)
         return;
     case csr_addr_t::sideleg:
         m_SupervisorInterruptDelegation = value;
+        m_InterruptGeneration++;
         return;
     case csr_addr_t::sie:
         m_InterruptEnable.SetWithMask(value, xie_t::SupervisorMask);
+        m_InterruptGeneration++;
         return;
     case csr_addr_t::stvec:
         m_SupervisorTrapVector.SetValue(value);
@@ -707,9 +767,11 @@ void Csr::WriteSupervisorModeRegister(csr_addr_t addr, uint64_t value)
         return;
     case csr_addr_t::sip:
         m_InterruptPending.SetWithMask(value, xip_t::WriteMask & xip_t::SupervisorMask);
+        m_InterruptGeneration++;
         return;
     case csr_addr_t::satp:
         m_SupervisorAddressTranslationProtection.SetValue(value);
+        m_TranslationGeneration++;
         return;
     default:
         PrintRegisterUnimplementedMessage(addr);
@@ -717,6 +779,7 @@ void Csr::WriteSupervisorModeRegister(csr_addr_t addr, uint64_t value)
     }
 }
 
+template <XLEN xlen>
 void Csr::WriteUserModeRegister(csr_addr_t addr, uint64_t value)
 {
     switch (addr)
@@ -735,6 +798,7 @@ void Csr::WriteUserModeRegister(csr_addr_t addr, uint64_t value)
         return;
     case csr_addr_t::uie:
         m_InterruptEnable.SetWithMask(value, xie_t::UserMask);
+        m_InterruptGeneration++;
         return;
     case csr_addr_t::utvec:
         m_UserTrapVector.SetValue(value);
@@ -753,43 +817,56 @@ void Csr::WriteUserModeRegister(csr_addr_t addr, uint64_t value)
         return;
     case csr_addr_t::uip:
         m_InterruptPending.SetWithMask(value, xip_t::WriteMask & xip_t::UserMask);
+        m_InterruptGeneration++;
         return;
     default:
-        if (addr == csr_addr_t::cycle && m_XLEN == XLEN::XLEN32)
+        if (addr == csr_addr_t::cycle && xlen == XLEN::XLEN32)
         {
-            SetLow32(&m_CycleCounter, value);
+            auto counter = GetCycleCounter();
+            SetLow32(&counter, value);
+            SetCycleCounter(counter);
         }
-        else if (addr == csr_addr_t::cycle && m_XLEN == XLEN::XLEN64)
+        else if (addr == csr_addr_t::cycle && xlen == XLEN::XLEN64)
         {
-            m_CycleCounter = value;
+            SetCycleCounter(value);
         }
-        else if (addr == csr_addr_t::time && m_XLEN == XLEN::XLEN32)
+        else if (addr == csr_addr_t::time && xlen == XLEN::XLEN32)
         {
-            SetLow32(&m_TimeCounter, value);
+            auto counter = GetTimeCounter();
+            SetLow32(&counter, value);
+            SetTimeCounter(counter);
         }
-        else if (addr == csr_addr_t::time && m_XLEN == XLEN::XLEN64)
+        else if (addr == csr_addr_t::time && xlen == XLEN::XLEN64)
         {
-            m_TimeCounter = value;
+            SetTimeCounter(value);
         }
-        else if (addr == csr_addr_t::instret && m_XLEN == XLEN::XLEN32)
+        else if (addr == csr_addr_t::instret && xlen == XLEN::XLEN32)
         {
-            SetLow32(&m_InstructionRetiredCounter, value);
+            auto counter = GetInstructionRetiredCounter();
+            SetLow32(&counter, value);
+            SetInstructionRetiredCounter(counter);
         }
-        else if (addr == csr_addr_t::instret && m_XLEN == XLEN::XLEN64)
+        else if (addr == csr_addr_t::instret && xlen == XLEN::XLEN64)
         {
-            m_InstructionRetiredCounter = value;
+            SetInstructionRetiredCounter(value);
         }
-        else if (addr == csr_addr_t::cycleh && m_XLEN == XLEN::XLEN32)
+        else if (addr == csr_addr_t::cycleh && xlen == XLEN::XLEN32)
         {
-            SetHigh32(&m_CycleCounter, value);
+            auto counter = GetCycleCounter();
+            SetHigh32(&counter, value);
+            SetCycleCounter(counter);
         }
-        else if (addr == csr_addr_t::timeh && m_XLEN == XLEN::XLEN32)
+        else if (addr == csr_addr_t::timeh && xlen == XLEN::XLEN32)
         {
-            SetHigh32(&m_CycleCounter, value);
+            auto counter = GetCycleCounter();
+            SetHigh32(&counter, value);
+            SetCycleCounter(counter);
         }
-        else if (addr == csr_addr_t::instreth && m_XLEN == XLEN::XLEN32)
+        else if (addr == csr_addr_t::instreth && xlen == XLEN::XLEN32)
         {
-            SetHigh32(&m_InstructionRetiredCounter, value);
+            auto counter = GetInstructionRetiredCounter();
+            SetHigh32(&counter, value);
+            SetInstructionRetiredCounter(counter);
         }
         else
         {
@@ -827,6 +904,36 @@ int Csr::GetPerformanceCounterIndex(csr_addr_t addr) const
     return static_cast<int>(addr) - static_cast<int>(base);
 }
 
+uint64_t Csr::GetCycleCounter() const
+{
+    return m_Cycle + m_CycleOffset;
+}
+
+void Csr::SetCycleCounter(uint64_t value)
+{
+    m_CycleOffset = value - m_Cycle;
+}
+
+uint64_t Csr::GetTimeCounter() const
+{
+    return m_Cycle + m_TimeOffset;
+}
+
+void Csr::SetTimeCounter(uint64_t value)
+{
+    m_TimeOffset = value - m_Cycle;
+}
+
+uint64_t Csr::GetInstructionRetiredCounter() const
+{
+    return m_Cycle + m_InstructionRetiredOffset;
+}
+
+void Csr::SetInstructionRetiredCounter(uint64_t value)
+{
+    m_InstructionRetiredOffset = value - m_Cycle;
+}
+
 void Csr::PrintRegisterUnimplementedMessage(csr_addr_t addr) const
 {
     printf("Detect unimplemented CSR access (addr=0x%03x).\n", static_cast<int>(addr));
@@ -859,4 +966,95 @@ void Csr::Copy(trace::Csr64Node* pOutNodes, int nodeCount) const
     }
 }
 
+// Configuration derived from XLEN is not saved. Generations are not saved either since they are compared only with caches of this process.
+void Csr::SaveState(SnapshotWriter* pWriter) const
+{
+    pWriter->Write(m_FpCsr);
+    pWriter->Write(m_Status);
+
+    pWriter->Write(m_MachineTrapVector);
+    pWriter->Write(m_SupervisorTrapVector);
+    pWriter->Write(m_UserTrapVector);
+
+    pWriter->Write(m_MachineExceptionDelegation);
+    pWriter->Write(m_SupervisorExceptionDelegation);
+    pWriter->Write(m_MachineInterruptDelegation);
+    pWriter->Write(m_SupervisorInterruptDelegation);
+    pWriter->Write(m_MachineCounterEnable);
+    pWriter->Write(m_SupervisorCounterEnable);
+
+    pWriter->Write(m_MachineScratch);
+    pWriter->Write(m_SupervisorScratch);
+    pWriter->Write(m_UserScratch);
+    pWriter->Write(m_MachineExceptionProgramCounter);
+    pWriter->Write(m_SupervisorExceptionProgramCounter);
+    pWriter->Write(m_UserExceptionProgramCounter);
+    pWriter->Write(m_MachineCause);
+    pWriter->Write(m_SupervisorCause);
+    pWriter->Write(m_UserCause);
+    pWriter->Write(m_MachineTrapValue);
+    pWriter->Write(m_SupervisorTrapValue);
+    pWriter->Write(m_UserTrapValue);
+
+    pWriter->Write(m_InterruptEnable);
+    pWriter->Write(m_InterruptPending);
+
+    pWriter->Write(m_SupervisorAddressTranslationProtection);
+
+    pWriter->Write(m_Cycle);
+    pWriter->Write(m_CycleOffset);
+    pWriter->Write(m_TimeOffset);
+    pWriter->Write(m_InstructionRetiredOffset);
+
+    pWriter->Write(m_ProgramCounter);
+    pWriter->Write(m_PrivilegeLevel);
+}
+
+void Csr::LoadState(SnapshotReader* pReader)
+{
+    pReader->Read(&m_FpCsr);
+    pReader->Read(&m_Status);
+
+    pReader->Read(&m_MachineTrapVector);
+    pReader->Read(&m_SupervisorTrapVector);
+    pReader->Read(&m_UserTrapVector);
+
+    pReader->Read(&m_MachineExceptionDelegation);
+    pReader->Read(&m_SupervisorExceptionDelegation);
+    pReader->Read(&m_MachineInterruptDelegation);
+    pReader->Read(&m_SupervisorInterruptDelegation);
+    pReader->Read(&m_MachineCounterEnable);
+    pReader->Read(&m_SupervisorCounterEnable);
+
+    pReader->Read(&m_MachineScratch);
+    pReader->Read(&m_SupervisorScratch);
+    pReader->Read(&m_UserScratch);
+    pReader->Read(&m_MachineExceptionProgramCounter);
+    pReader->Read(&m_SupervisorExceptionProgramCounter);
+    pReader->Read(&m_UserExceptionProgramCounter);
+    pReader->Read(&m_MachineCause);
+    pReader->Read(&m_SupervisorCause);
+    pReader->Read(&m_UserCause);
+    pReader->Read(&m_MachineTrapValue);
+    pReader->Read(&m_SupervisorTrapValue);
+    pReader->Read(&m_UserTrapValue);
+
+    pReader->Read(&m_InterruptEnable);
+    pReader->Read(&m_InterruptPending);
+
+    pReader->Read(&m_SupervisorAddressTranslationProtection);
+
+    pReader->Read(&m_Cycle);
+    pReader->Read(&m_CycleOffset);
+    pReader->Read(&m_TimeOffset);
+    pReader->Read(&m_InstructionRetiredOffset);
+
+    pReader->Read(&m_ProgramCounter);
+    pReader->Read(&m_PrivilegeLevel);
+
+    // States cached with the current generations are stale.
+    m_InterruptGeneration++;
+    m_TranslationGeneration++;
+}
+
 }}}
@@ -21,6 +21,8 @@
 
 #include <rafi/emu.h>
 
+#include "../Snapshot.h"
+
 #include "Trap.h"
 
 namespace rafi { namespace emu { namespace cpu {
@@ -33,7 +35,15 @@ public:
     std::optional<Trap> CheckTrap(csr_addr_t addr, bool write, vaddr_t pc, uint32_t insn) const;
 
     // Update registers for cycle
-    void ProcessCycle();
+    void ProcessCycle()
+    {
+        m_Cycle++;
+    }
+
+    void ProcessCycles(int cycleCount)
+    {
+        m_Cycle += cycleCount;
+    }
 
     // Special register access
     vaddr_t GetProgramCounter() const;
@@ -56,6 +66,12 @@ public:
     satp_t ReadSatp() const;
     uint64_t ReadTime() const;
 
+    // Incremented when satp or bits of mstatus which affect address translation (MPRV, SUM and MXR) are changed.
+    uint64_t GetTranslationGeneration() const;
+
+    // Incremented when a state which affects interrupt requests (xstatus, xie, xip, xideleg, time or privilege level) is changed.
+    uint64_t GetInterruptGeneration() const;
+
     void WriteFpCsr(const fcsr_t& value);
     void WriteInterruptPending(const xip_t& value);
     void WriteStatus(const xstatus_t& value);
@@ -66,6 +82,10 @@ public:
     void Copy(trace::Csr32Node* pOutNodes, int nodeCount) const;
     void Copy(trace::Csr64Node* pOutNodes, int nodeCount) const;
 
+    // for snapshot
+    void SaveState(SnapshotWriter* pWriter) const;
+    void LoadState(SnapshotReader* pReader);
+
 private:
     static const int RegisterAddrWidth = 12;
 	static const int NumberOfRegister = 1 << RegisterAddrWidth;
@@ -76,21 +96,43 @@ private:
     bool IsReservedModeRegister(csr_addr_t addr) const;
     bool IsMachineModeRegister(csr_addr_t addr) const;
 
+    // Register access is specialized for XLEN. ReadUInt64() and WriteUInt64() select the specialization by m_XLEN.
+    template <XLEN xlen>
+    uint64_t ReadRegister(csr_addr_t addr) const;
+    template <XLEN xlen>
+    void WriteRegister(csr_addr_t addr, uint64_t value);
+
+    template <XLEN xlen>
     uint64_t ReadMachineModeRegister(csr_addr_t addr) const;
+    template <XLEN xlen>
 	uint64_t ReadSupervisorModeRegister(csr_addr_t addr) const;
+    template <XLEN xlen>
 	uint64_t ReadUserModeRegister(csr_addr_t addr) const;
 
+    template <XLEN xlen>
 	void WriteMachineModeRegister(csr_addr_t addr, uint64_t value);
+    template <XLEN xlen>
     void WriteSupervisorModeRegister(csr_addr_t addr, uint64_t value);
+    template <XLEN xlen>
     void WriteUserModeRegister(csr_addr_t addr, uint64_t value);
 
     int GetPerformanceCounterIndex(csr_addr_t addr) const;
+
+    uint64_t GetCycleCounter() const;
+    uint64_t GetTimeCounter() const;
+    uint64_t GetInstructionRetiredCounter() const;
+    void SetCycleCounter(uint64_t value);
+    void SetTimeCounter(uint64_t value);
+    void SetInstructionRetiredCounter(uint64_t value);
     void PrintRegisterUnimplementedMessage(csr_addr_t addr) const;
 
     // Configuration
     XLEN m_XLEN;
     misa_t m_ISA;
 
+    // SD bit of xstatus for XLEN
+    uint64_t m_StatusSdMask{ 0 };
+
     // Floating point
     fcsr_t m_FpCsr {0};
 
@@ -130,14 +172,18 @@ private:
     // Interrupt
     xie_t m_InterruptEnable {0};
     xip_t m_InterruptPending {0};
+    uint64_t m_InterruptGeneration {0};
 
     // Protection and Translation (0x180-0x1bf and 0x380-0x3bf)
     satp_t m_SupervisorAddressTranslationProtection {0};
+    uint64_t m_TranslationGeneration {0};
 
     // Performance Counters
-    uint64_t m_CycleCounter {0};
-    uint64_t m_TimeCounter {0};
-    uint64_t m_InstructionRetiredCounter {0};
+    // Counters are derived from the processed cycle count and offsets set by writes.
+    uint64_t m_Cycle {0};
+    uint64_t m_CycleOffset {0};
+    uint64_t m_TimeOffset {0};
+    uint64_t m_InstructionRetiredOffset {0};
 
     // Special registers
     vaddr_t m_ProgramCounter {0};
@@ -0,0 +1,133 @@
+/*
+ * Copyright 2018 Akifumi Fujita
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+
+#include <rafi/emu.h>
+
+#include "DecodeCache.h"
+
+namespace rafi { namespace emu { namespace cpu {
+
+const DecodeCacheEntry* DecodeCache::Find(paddr_t address)
+{
+    auto pPage = FindPage(address / PageSize);
+    if (pPage == nullptr)
+    {
+        return nullptr;
+    }
+
+    const auto& entry = pPage->entries[(address % PageSize) / 2];
+
+    return entry.size == 0 ? nullptr : &entry;
+}
+
+void DecodeCache::Insert(paddr_t address, const Op& op, uint32_t insn, int size)
+{
+    if (!IsCacheable(address))
+    {
+        return;
+    }
+
+    const auto pageNumber = address / PageSize;
+
+    auto pPage = FindPage(pageNumber);
+    if (pPage == nullptr)
+    {
+        auto page = std::make_unique<Page>();
+        pPage = page.get();
+
+        m_Pages.emplace(pageNumber, std::move(page));
+
+        m_LastPageNumber = pageNumber;
+        m_pLastPage = pPage;
+    }
+
+    auto& entry = pPage->entries[(address % PageSize) / 2];
+
+    entry.op = op;
+    entry.insn = insn;
+    entry.size = size;
+}
+
+void DecodeCache::Invalidate(paddr_t address, size_t size)
+{
+    if (m_Pages.empty() || size == 0)
+    {
+        return;
+    }
+
+    // An entry holds 4 bytes from its address, so the entry just before the written range is also stale.
+    const paddr_t low = address < 2 ? 0 : address - 2;
+    const paddr_t high = address + size - 1;
+
+    for (auto pageNumber = low / PageSize; pageNumber <= high / PageSize; pageNumber++)
+    {
+        auto pPage = FindPage(pageNumber);
+        if (pPage == nullptr)
+        {
+            continue;
+        }
+
+        const auto pageBase = pageNumber * PageSize;
+        const auto begin = (std::max(low, pageBase) - pageBase) / 2;
+        const auto end = (std::min(high, pageBase + PageSize - 1) - pageBase) / 2;
+
+        for (auto i = begin; i <= end; i++)
+        {
+            pPage->entries[i].size = 0;
+        }
+    }
+}
+
+void DecodeCache::InvalidateAll()
+{
+    m_Pages.clear();
+
+    m_LastPageNumber = 0;
+    m_pLastPage = nullptr;
+}
+
+void DecodeCache::OnMemoryWrite(paddr_t address, size_t size)
+{
+    Invalidate(address, size);
+}
+
+bool DecodeCache::IsCacheable(paddr_t address)
+{
+    return address % PageSize <= PageSize - 4;
+}
+
+DecodeCache::Page* DecodeCache::FindPage(paddr_t pageNumber)
+{
+    if (m_pLastPage != nullptr && m_LastPageNumber == pageNumber)
+    {
+        return m_pLastPage;
+    }
+
+    const auto it = m_Pages.find(pageNumber);
+    if (it == m_Pages.end())
+    {
+        return nullptr;
+    }
+
+    m_LastPageNumber = pageNumber;
+    m_pLastPage = it->second.get();
+
+    return m_pLastPage;
+}
+
+}}}
@@ -0,0 +1,69 @@
+/*
+ * Copyright 2018 Akifumi Fujita
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <memory>
+#include <unordered_map>
+
+#include <rafi/common.h>
+#include <rafi/emu.h>
+
+#include "../bus/IBusObserver.h"
+
+namespace rafi { namespace emu { namespace cpu {
+
+struct DecodeCacheEntry
+{
+    Op op;
+    uint32_t insn{ 0 };
+    int size{ 0 }; // 0 for invalid entry
+};
+
+// Cache of decoded ops keyed by physical pc.
+// An entry holds the 4-byte fetch word, so an op at the last halfword of a page must not be cached.
+class DecodeCache final : public bus::IBusObserver
+{
+public:
+    const DecodeCacheEntry* Find(paddr_t address);
+    void Insert(paddr_t address, const Op& op, uint32_t insn, int size);
+
+    void Invalidate(paddr_t address, size_t size);
+    void InvalidateAll();
+
+    void OnMemoryWrite(paddr_t address, size_t size) override;
+
+    static bool IsCacheable(paddr_t address);
+
+private:
+    static const int PageSize = 0x1000;
+    static const int EntryCount = PageSize / 2;
+
+    struct Page
+    {
+        DecodeCacheEntry entries[EntryCount];
+    };
+
+    Page* FindPage(paddr_t pageNumber);
+
+    std::unordered_map<paddr_t, std::unique_ptr<Page>> m_Pages;
+
+    // Most ops are fetched from the same page as the previous op
+    paddr_t m_LastPageNumber{ 0 };
+    Page* m_pLastPage{ nullptr };
+};
+
+}}}
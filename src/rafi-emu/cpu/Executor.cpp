@@ -27,6 +27,8 @@
 #include <rafi/emu.h>
 #include <rafi/fp.h>
 
+#include "BasicBlockCache.h"
+#include "DecodeCache.h"
 #include "Executor.h"
 
 #pragma fenv_access (on)
@@ -228,6 +230,265 @@ void Executor::ProcessOp(const Op& op, vaddr_t pc)
     }
 }
 
+Executor::Handler Executor::GetHandler(const Op& op) const
+{
+    switch (op.opClass)
+    {
+    case OpClass::RV32I:
+        return GetHandlerRV32I(op);
+    case OpClass::RV64I:
+        return GetHandlerRV64I(op);
+    case OpClass::RV64C:
+        return GetHandlerRV64C(op);
+    case OpClass::RV32C:
+        return &Executor::ProcessRV32C;
+    case OpClass::RV32M:
+        return &Executor::ProcessWithoutPc<&Executor::ProcessRV32M>;
+    case OpClass::RV64M:
+        return &Executor::ProcessWithoutPc<&Executor::ProcessRV64M>;
+    case OpClass::RV32A:
+        return &Executor::ProcessWithoutPc<&Executor::ProcessRV32A>;
+    case OpClass::RV64A:
+        return &Executor::ProcessWithoutPc<&Executor::ProcessRV64A>;
+    case OpClass::RV32F:
+    case OpClass::RV64F:
+        return &Executor::ProcessWithoutPc<&Executor::ProcessRVF>;
+    case OpClass::RV32D:
+    case OpClass::RV64D:
+        return &Executor::ProcessWithoutPc<&Executor::ProcessRVD>;
+    default:
+        return &Executor::ProcessOp;
+    }
+}
+
+Executor::Handler Executor::GetHandlerRV32I(const Op& op) const
+{
+    switch (op.opCode)
+    {
+    case OpCode::lui:
+        return &Executor::ProcessWithoutPc<&Executor::ProcessRV32I_Lui>;
+    case OpCode::auipc:
+        return &Executor::ProcessRV32I_Auipc;
+    case OpCode::jal:
+        return &Executor::ProcessRV32I_Jal;
+    case OpCode::jalr:
+        return &Executor::ProcessRV32I_Jalr;
+    case OpCode::beq:
+    case OpCode::bne:
+    case OpCode::blt:
+    case OpCode::bge:
+    case OpCode::bltu:
+    case OpCode::bgeu:
+        return &Executor::ProcessRV32I_Branch;
+    case OpCode::lb:
+    case OpCode::lh:
+    case OpCode::lw:
+    case OpCode::lbu:
+    case OpCode::lhu:
+        return &Executor::ProcessWithoutPc<&Executor::ProcessRV32I_Load>;
+    case OpCode::sb:
+    case OpCode::sh:
+    case OpCode::sw:
+        return &Executor::ProcessWithoutPc<&Executor::ProcessRV32I_Store>;
+    case OpCode::addi:
+    case OpCode::slti:
+    case OpCode::sltiu:
+    case OpCode::xori:
+    case OpCode::ori:
+    case OpCode::andi:
+        return &Executor::ProcessWithoutPc<&Executor::ProcessRV32I_AluImm>;
+    case OpCode::sll:
+    case OpCode::srl:
+    case OpCode::sra:
+        return &Executor::ProcessWithoutPc<&Executor::ProcessRV32I_Shift>;
+    case OpCode::slli:
+    case OpCode::srli:
+    case OpCode::srai:
+        return &Executor::ProcessWithoutPc<&Executor::ProcessRV32I_ShiftImm>;
+    case OpCode::add:
+    case OpCode::sub:
+    case OpCode::slt:
+    case OpCode::sltu:
+    case OpCode::xor_:
+    case OpCode::or_:
+    case OpCode::and_:
+        return &Executor::ProcessWithoutPc<&Executor::ProcessRV32I_Alu>;
+    case OpCode::ecall:
+    case OpCode::ebreak:
+    case OpCode::mret:
+    case OpCode::sret:
+    case OpCode::uret:
+    case OpCode::wfi:
+        return &Executor::ProcessWithoutPc<&Executor::ProcessRV32I_Priv>;
+    case OpCode::fence:
+    case OpCode::fence_i:
+    case OpCode::sfence_vma:
+        return &Executor::ProcessWithoutPc<&Executor::ProcessRV32I_Fence>;
+    case OpCode::csrrw:
+    case OpCode::csrrs:
+    case OpCode::csrrc:
+        return &Executor::ProcessWithoutPc<&Executor::ProcessRV32I_Csr>;
+    case OpCode::csrrwi:
+    case OpCode::csrrsi:
+    case OpCode::csrrci:
+        return &Executor::ProcessWithoutPc<&Executor::ProcessRV32I_CsrImm>;
+    default:
+        return &Executor::ProcessOp;
+    }
+}
+
+Executor::Handler Executor::GetHandlerRV64I(const Op& op) const
+{
+    switch (op.opCode)
+    {
+    case OpCode::lui:
+        return &Executor::ProcessWithoutPc<&Executor::ProcessRV64I_Lui>;
+    case OpCode::auipc:
+        return &Executor::ProcessRV64I_Auipc;
+    case OpCode::jal:
+        return &Executor::ProcessRV64I_Jal;
+    case OpCode::jalr:
+        return &Executor::ProcessRV64I_Jalr;
+    case OpCode::beq:
+    case OpCode::bne:
+    case OpCode::blt:
+    case OpCode::bge:
+    case OpCode::bltu:
+    case OpCode::bgeu:
+        return &Executor::ProcessRV64I_Branch;
+    case OpCode::lb:
+    case OpCode::lh:
+    case OpCode::lw:
+    case OpCode::ld:
+    case OpCode::lbu:
+    case OpCode::lhu:
+    case OpCode::lwu:
+        return &Executor::ProcessWithoutPc<&Executor::ProcessRV64I_Load>;
+    case OpCode::sb:
+    case OpCode::sh:
+    case OpCode::sw:
+    case OpCode::sd:
+        return &Executor::ProcessWithoutPc<&Executor::ProcessRV64I_Store>;
+    case OpCode::addi:
+    case OpCode::addiw:
+    case OpCode::slti:
+    case OpCode::sltiu:
+    case OpCode::xori:
+    case OpCode::ori:
+    case OpCode::andi:
+        return &Executor::ProcessWithoutPc<&Executor::ProcessRV64I_AluImm>;
+    case OpCode::sll:
+    case OpCode::sllw:
+    case OpCode::srl:
+    case OpCode::srlw:
+    case OpCode::sra:
+    case OpCode::sraw:
+        return &Executor::ProcessWithoutPc<&Executor::ProcessRV64I_Shift>;
+    case OpCode::slli:
+    case OpCode::slliw:
+    case OpCode::srli:
+    case OpCode::srliw:
+    case OpCode::srai:
+    case OpCode::sraiw:
+        return &Executor::ProcessWithoutPc<&Executor::ProcessRV64I_ShiftImm>;
+    case OpCode::add:
+    case OpCode::addw:
+    case OpCode::sub:
+    case OpCode::subw:
+    case OpCode::slt:
+    case OpCode::sltu:
+    case OpCode::xor_:
+    case OpCode::or_:
+    case OpCode::and_:
+        return &Executor::ProcessWithoutPc<&Executor::ProcessRV64I_Alu>;
+    case OpCode::ecall:
+    case OpCode::ebreak:
+    case OpCode::mret:
+    case OpCode::sret:
+    case OpCode::uret:
+    case OpCode::wfi:
+        return &Executor::ProcessWithoutPc<&Executor::ProcessRV64I_Priv>;
+    case OpCode::fence:
+    case OpCode::fence_i:
+    case OpCode::sfence_vma:
+        return &Executor::ProcessWithoutPc<&Executor::ProcessRV64I_Fence>;
+    case OpCode::csrrw:
+    case OpCode::csrrs:
+    case OpCode::csrrc:
+        return &Executor::ProcessWithoutPc<&Executor::ProcessRV64I_Csr>;
+    case OpCode::csrrwi:
+    case OpCode::csrrsi:
+    case OpCode::csrrci:
+        return &Executor::ProcessWithoutPc<&Executor::ProcessRV64I_CsrImm>;
+    default:
+        return &Executor::ProcessOp;
+    }
+}
+
+Executor::Handler Executor::GetHandlerRV64C(const Op& op) const
+{
+    switch (op.opCode)
+    {
+    case OpCode::c_mv:
+    case OpCode::c_add:
+    case OpCode::c_addw:
+    case OpCode::c_sub:
+    case OpCode::c_subw:
+    case OpCode::c_and:
+    case OpCode::c_or:
+    case OpCode::c_xor:
+        return &Executor::ProcessWithoutPc<&Executor::ProcessRV64C_Alu>;
+    case OpCode::c_li:
+    case OpCode::c_lui:
+    case OpCode::c_addi:
+    case OpCode::c_addiw:
+    case OpCode::c_andi:
+    case OpCode::c_srli:
+    case OpCode::c_srai:
+    case OpCode::c_slli:
+        return &Executor::ProcessWithoutPc<&Executor::ProcessRV64C_AluImm>;
+    case OpCode::c_beqz:
+    case OpCode::c_bnez:
+        return &Executor::ProcessRV64C_Branch;
+    case OpCode::c_addi4spn:
+        return &Executor::ProcessWithoutPc<&Executor::ProcessRV64C_ADDI4SPN>;
+    case OpCode::c_addi16sp:
+        return &Executor::ProcessWithoutPc<&Executor::ProcessRV64C_ADDI16SP>;
+    case OpCode::c_fld:
+        return &Executor::ProcessWithoutPc<&Executor::ProcessRV64C_FLD>;
+    case OpCode::c_fldsp:
+        return &Executor::ProcessWithoutPc<&Executor::ProcessRV64C_FLDSP>;
+    case OpCode::c_fsd:
+        return &Executor::ProcessWithoutPc<&Executor::ProcessRV64C_FSD>;
+    case OpCode::c_fsdsp:
+        return &Executor::ProcessWithoutPc<&Executor::ProcessRV64C_FSDSP>;
+    case OpCode::c_j:
+        return &Executor::ProcessRV64C_J;
+    case OpCode::c_jr:
+        return &Executor::ProcessRV64C_JR;
+    case OpCode::c_jalr:
+        return &Executor::ProcessRV64C_JALR;
+    case OpCode::c_ld:
+        return &Executor::ProcessWithoutPc<&Executor::ProcessRV64C_LD>;
+    case OpCode::c_ldsp:
+        return &Executor::ProcessWithoutPc<&Executor::ProcessRV64C_LDSP>;
+    case OpCode::c_lw:
+        return &Executor::ProcessWithoutPc<&Executor::ProcessRV64C_LW>;
+    case OpCode::c_lwsp:
+        return &Executor::ProcessWithoutPc<&Executor::ProcessRV64C_LWSP>;
+    case OpCode::c_sd:
+        return &Executor::ProcessWithoutPc<&Executor::ProcessRV64C_SD>;
+    case OpCode::c_sdsp:
+        return &Executor::ProcessWithoutPc<&Executor::ProcessRV64C_SDSP>;
+    case OpCode::c_sw:
+        return &Executor::ProcessWithoutPc<&Executor::ProcessRV64C_SW>;
+    case OpCode::c_swsp:
+        return &Executor::ProcessWithoutPc<&Executor::ProcessRV64C_SWSP>;
+    default:
+        return &Executor::ProcessRV64C;
+    }
+}
+
 std::optional<Trap> Executor::PreCheckTrapRV32C(const Op& op, vaddr_t pc) const
 {
     switch (op.opCode)
@@ -773,7 +1034,7 @@ void Executor::ProcessRV32I(const Op& op, vaddr_t pc)
     case OpCode::fence:
     case OpCode::fence_i:
     case OpCode::sfence_vma:
-        ProcessRV32I_Fence();
+        ProcessRV32I_Fence(op);
         return;
     case OpCode::csrrw:
     case OpCode::csrrs:
@@ -1251,7 +1512,7 @@ void Executor::ProcessRV64I(const Op& op, vaddr_t pc)
     case OpCode::fence:
     case OpCode::fence_i:
     case OpCode::sfence_vma:
-        ProcessRV64I_Fence();
+        ProcessRV64I_Fence(op);
         return;
     case OpCode::csrrw:
     case OpCode::csrrs:
@@ -1845,9 +2106,19 @@ void Executor::ProcessRV32I_Priv(const Op& op)
     }
 }
 
-void Executor::ProcessRV32I_Fence()
+void Executor::ProcessRV32I_Fence(const Op& op)
 {
     m_pAtomicManager->Cancel();
+
+    if (op.opCode == OpCode::fence_i)
+    {
+        m_pDecodeCache->InvalidateAll();
+        m_pBasicBlockCache->InvalidateAll();
+    }
+    else if (op.opCode == OpCode::sfence_vma)
+    {
+        m_pMemAccessUnit->FlushTlb();
+    }
 }
 
 void Executor::ProcessRV32I_Csr(const Op& op)
@@ -2248,9 +2519,19 @@ void Executor::ProcessRV64I_Priv(const Op& op)
     }
 }
 
-void Executor::ProcessRV64I_Fence()
+void Executor::ProcessRV64I_Fence(const Op& op)
 {
     m_pAtomicManager->Cancel();
+
+    if (op.opCode == OpCode::fence_i)
+    {
+        m_pDecodeCache->InvalidateAll();
+        m_pBasicBlockCache->InvalidateAll();
+    }
+    else if (op.opCode == OpCode::sfence_vma)
+    {
+        m_pMemAccessUnit->FlushTlb();
+    }
 }
 
 void Executor::ProcessRV64I_Csr(const Op& op)
@@ -30,16 +30,23 @@
 
 namespace rafi { namespace emu { namespace cpu {
 
+class BasicBlockCache;
+class DecodeCache;
+
 class Executor
 {
 public:
-    Executor(AtomicManager* pAtomicManager, Csr* pCsr, TrapProcessor* pTrapProcessor, IntRegFile* pIntRegFile, FpRegFile* pFpRegFile, MemoryAccessUnit* pMemAccessUnit)
+    using Handler = void (Executor::*)(const Op& op, vaddr_t pc);
+
+    Executor(AtomicManager* pAtomicManager, Csr* pCsr, TrapProcessor* pTrapProcessor, IntRegFile* pIntRegFile, FpRegFile* pFpRegFile, MemoryAccessUnit* pMemAccessUnit, DecodeCache* pDecodeCache, BasicBlockCache* pBasicBlockCache)
         : m_pAtomicManager(pAtomicManager)
         , m_pCsr(pCsr)
         , m_pTrapProcessor(pTrapProcessor)
         , m_pIntRegFile(pIntRegFile)
         , m_pFpRegFile(pFpRegFile)
         , m_pMemAccessUnit(pMemAccessUnit)
+        , m_pDecodeCache(pDecodeCache)
+        , m_pBasicBlockCache(pBasicBlockCache)
     {
     }
 
@@ -49,7 +56,15 @@ public:
 
     void ProcessOp(const Op& op, vaddr_t pc);
 
+    // Returns the handler which processes op without dispatching by opClass and opCode.
+    Handler GetHandler(const Op& op) const;
+
 private:
+    // GetHandler
+    Handler GetHandlerRV32I(const Op& op) const;
+    Handler GetHandlerRV64I(const Op& op) const;
+    Handler GetHandlerRV64C(const Op& op) const;
+
     // PreCheckTrap
     std::optional<Trap> PreCheckTrapRV32_Load(const Op& op, vaddr_t pc) const;
     std::optional<Trap> PreCheckTrapRV32_LoadReserved(const Op& op, vaddr_t pc) const;
@@ -103,6 +118,13 @@ private:
     // PostCheckTrap
     std::optional<Trap> PostCheckTrapForEcall(vaddr_t pc) const;
 
+    // Adapter to use a process function without pc as Handler
+    template <void (Executor::*Function)(const Op& op)>
+    void ProcessWithoutPc(const Op& op, vaddr_t)
+    {
+        (this->*Function)(op);
+    }
+
     // Process
     void ProcessRV32I(const Op& op, vaddr_t pc);
     void ProcessRV32M(const Op& op);
@@ -129,7 +151,7 @@ private:
     void ProcessRV32I_AluImm(const Op& op);
     void ProcessRV32I_Shift(const Op& op);
     void ProcessRV32I_ShiftImm(const Op& op);
-    void ProcessRV32I_Fence();
+    void ProcessRV32I_Fence(const Op& op);
     void ProcessRV32I_Priv(const Op& op);
     void ProcessRV32I_Csr(const Op& op);
     void ProcessRV32I_CsrImm(const Op& op);
@@ -146,7 +168,7 @@ private:
     void ProcessRV64I_AluImm(const Op& op);
     void ProcessRV64I_Shift(const Op& op);
     void ProcessRV64I_ShiftImm(const Op& op);
-    void ProcessRV64I_Fence();
+    void ProcessRV64I_Fence(const Op& op);
     void ProcessRV64I_Priv(const Op& op);
     void ProcessRV64I_Csr(const Op& op);
     void ProcessRV64I_CsrImm(const Op& op);
@@ -264,6 +286,8 @@ private:
     IntRegFile* m_pIntRegFile;
     FpRegFile* m_pFpRegFile;
     MemoryAccessUnit* m_pMemAccessUnit;
+    DecodeCache* m_pDecodeCache;
+    BasicBlockCache* m_pBasicBlockCache;
 };
 
 }}}
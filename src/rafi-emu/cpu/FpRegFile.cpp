@@ -92,4 +92,14 @@ void FpRegFile::WriteDouble(int regId, double value)
     m_Entries[regId].d.value = value;
 }
 
+void FpRegFile::SaveState(SnapshotWriter* pWriter) const
+{
+    pWriter->Write(m_Entries);
+}
+
+void FpRegFile::LoadState(SnapshotReader* pReader)
+{
+    pReader->Read(&m_Entries);
+}
+
 }}}
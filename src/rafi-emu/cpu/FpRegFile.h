@@ -21,6 +21,8 @@
 
 #include <rafi/emu.h>
 
+#include "../Snapshot.h"
+
 namespace rafi { namespace emu { namespace cpu {
 
 class FpRegFile
@@ -30,6 +32,9 @@ public:
 
     void Copy(void* pOut, size_t size) const;
 
+    void SaveState(SnapshotWriter* pWriter) const;
+    void LoadState(SnapshotReader* pReader);
+
     uint32_t ReadUInt32(int regId) const;
     uint64_t ReadUInt64(int regId) const;
 	float ReadFloat(int regId) const;
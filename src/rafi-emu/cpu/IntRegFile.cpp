@@ -43,72 +43,19 @@ void IntRegFile::Copy(trace::NodeIntReg64* pOut) const
     }
 }
 
-int32_t IntRegFile::ReadInt32(int regId) const
+void* IntRegFile::GetRawPointer()
 {
-    RAFI_EMU_CHECK_RANGE(0, regId, IntRegCount);
-    
-    return m_Entries[regId].s32.value;
+    return m_Entries;
 }
 
-int64_t IntRegFile::ReadInt64(int regId) const
+void IntRegFile::SaveState(SnapshotWriter* pWriter) const
 {
-    RAFI_EMU_CHECK_RANGE(0, regId, IntRegCount);
-    
-    return m_Entries[regId].s64.value;
+    pWriter->Write(m_Entries);
 }
 
-uint32_t IntRegFile::ReadUInt32(int regId) const
+void IntRegFile::LoadState(SnapshotReader* pReader)
 {
-    RAFI_EMU_CHECK_RANGE(0, regId, IntRegCount);
-
-    return m_Entries[regId].u32.value;
-}
-
-uint64_t IntRegFile::ReadUInt64(int regId) const
-{
-    RAFI_EMU_CHECK_RANGE(0, regId, IntRegCount);
-
-    return m_Entries[regId].u64.value;
-}
-
-void IntRegFile::WriteInt32(int regId, int32_t value)
-{
-    RAFI_EMU_CHECK_RANGE(0, regId, IntRegCount);
-
-    if (regId != 0)
-    {
-        m_Entries[regId].s32.value = value;
-    }
-}
-
-void IntRegFile::WriteInt64(int regId, int64_t value)
-{
-    RAFI_EMU_CHECK_RANGE(0, regId, IntRegCount);
-
-    if (regId != 0)
-    {
-        m_Entries[regId].s64.value = value;
-    }
-}
-
-void IntRegFile::WriteUInt32(int regId, uint32_t value)
-{
-    RAFI_EMU_CHECK_RANGE(0, regId, IntRegCount);
-    
-    if (regId != 0)
-    {
-        m_Entries[regId].u32.value = value;
-    }
-}
-
-void IntRegFile::WriteUInt64(int regId, uint64_t value)
-{
-    RAFI_EMU_CHECK_RANGE(0, regId, IntRegCount);
-    
-    if (regId != 0)
-    {
-        m_Entries[regId].u64.value = value;
-    }
+    pReader->Read(&m_Entries);
 }
 
 }}}
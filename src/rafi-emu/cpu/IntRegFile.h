@@ -21,6 +21,8 @@
 
 #include <rafi/emu.h>
 
+#include "../Snapshot.h"
+
 namespace rafi { namespace emu { namespace cpu {
 
 class IntRegFile
@@ -31,15 +33,80 @@ public:
     void Copy(trace::NodeIntReg32* pOut) const;
     void Copy(trace::NodeIntReg64* pOut) const;
 
-	int32_t ReadInt32(int regId) const;
-	int64_t ReadInt64(int regId) const;
-	uint32_t ReadUInt32(int regId) const;
-	uint64_t ReadUInt64(int regId) const;
+    void SaveState(SnapshotWriter* pWriter) const;
+    void LoadState(SnapshotReader* pReader);
+
+    // Accessors are defined in the header to be inlined into Executor.
+    int32_t ReadInt32(int regId) const
+    {
+        RAFI_EMU_CHECK_RANGE(0, regId, IntRegCount);
+
+        return m_Entries[regId].s32.value;
+    }
+
+    int64_t ReadInt64(int regId) const
+    {
+        RAFI_EMU_CHECK_RANGE(0, regId, IntRegCount);
+
+        return m_Entries[regId].s64.value;
+    }
+
+    uint32_t ReadUInt32(int regId) const
+    {
+        RAFI_EMU_CHECK_RANGE(0, regId, IntRegCount);
+
+        return m_Entries[regId].u32.value;
+    }
+
+    uint64_t ReadUInt64(int regId) const
+    {
+        RAFI_EMU_CHECK_RANGE(0, regId, IntRegCount);
+
+        return m_Entries[regId].u64.value;
+    }
+
+    void WriteInt32(int regId, int32_t value)
+    {
+        RAFI_EMU_CHECK_RANGE(0, regId, IntRegCount);
+
+        if (regId != 0)
+        {
+            m_Entries[regId].s32.value = value;
+        }
+    }
+
+    void WriteInt64(int regId, int64_t value)
+    {
+        RAFI_EMU_CHECK_RANGE(0, regId, IntRegCount);
+
+        if (regId != 0)
+        {
+            m_Entries[regId].s64.value = value;
+        }
+    }
+
+    void WriteUInt32(int regId, uint32_t value)
+    {
+        RAFI_EMU_CHECK_RANGE(0, regId, IntRegCount);
+
+        if (regId != 0)
+        {
+            m_Entries[regId].u32.value = value;
+        }
+    }
+
+    void WriteUInt64(int regId, uint64_t value)
+    {
+        RAFI_EMU_CHECK_RANGE(0, regId, IntRegCount);
+
+        if (regId != 0)
+        {
+            m_Entries[regId].u64.value = value;
+        }
+    }
 
-    void WriteInt32(int regId, int32_t value);
-    void WriteInt64(int regId, int64_t value);
-    void WriteUInt32(int regId, uint32_t value);
-    void WriteUInt64(int regId, uint64_t value);
+    // for jit
+    void* GetRawPointer();
 
 private:
     union Entry
@@ -59,10 +59,19 @@ bool InterruptController::IsRequested() const
     return m_IsRequested;
 }
 
-void InterruptController::Update()
+void InterruptController::NotifySourceChanged()
+{
+    m_SourceChanged = true;
+}
+
+void InterruptController::Evaluate()
 {
     UpdateCsr();
 
+    // UpdateCsr() itself changes the generation.
+    m_SourceChanged = false;
+    m_Generation = m_pCsr->GetInterruptGeneration();
+
     const xstatus_t status = m_pCsr->ReadStatus();
     const xie_t ie = m_pCsr->ReadInterruptEnable();
     const xip_t ip = m_pCsr->ReadInterruptPending();
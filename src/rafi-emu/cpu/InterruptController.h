@@ -34,18 +34,32 @@ public:
 
     bool IsRequested() const;
 
-    void Update();
+    // Requests are evaluated again only if csr or interrupt sources may have changed.
+    void Update()
+    {
+        if (m_SourceChanged || m_Generation != m_pCsr->GetInterruptGeneration())
+        {
+            Evaluate();
+        }
+    }
+
+    // Called when requests from interrupt sources may have changed.
+    void NotifySourceChanged();
 
     void RegisterExternalInterruptSource(IInterruptSource* pInterruptSource);
     void RegisterTimerInterruptSource(IInterruptSource* pInterruptSource);
 
 private:
+    void Evaluate();
     void UpdateCsr();
 
     Csr* m_pCsr { nullptr };
     IInterruptSource* m_pExternalInterruptSource { nullptr };
     IInterruptSource* m_pTimerInterruptSource { nullptr };
 
+    bool m_SourceChanged { true };
+    uint64_t m_Generation { 0 };
+
     bool m_IsRequested { false };
     InterruptType m_InterruptType;
 };
@@ -0,0 +1,885 @@
+/*
+ * Copyright 2018 Akifumi Fujita
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cstring>
+
+#ifdef WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#include <rafi/emu.h>
+
+#include "BasicBlockCache.h"
+#include "JitCompiler.h"
+
+namespace rafi { namespace emu { namespace cpu {
+
+namespace {
+
+// x86 condition codes
+const uint8_t ConditionB = 0x2;
+const uint8_t ConditionAE = 0x3;
+const uint8_t ConditionE = 0x4;
+const uint8_t ConditionNE = 0x5;
+const uint8_t ConditionL = 0xc;
+const uint8_t ConditionGE = 0xd;
+
+// Extensions of ModR/M reg field
+const uint8_t ExtAdd = 0;
+const uint8_t ExtOr = 1;
+const uint8_t ExtAnd = 4;
+const uint8_t ExtXor = 6;
+const uint8_t ExtCmp = 7;
+const uint8_t ExtMul = 4;
+const uint8_t ExtImul = 5;
+const uint8_t ExtShl = 4;
+const uint8_t ExtShr = 5;
+const uint8_t ExtSar = 7;
+
+bool IsInt32(int64_t value)
+{
+    return INT32_MIN <= value && value <= INT32_MAX;
+}
+
+size_t GetPageSize()
+{
+#ifdef WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return info.dwPageSize;
+#else
+    return static_cast<size_t>(sysconf(_SC_PAGESIZE));
+#endif
+}
+
+}
+
+JitCompiler::JitCompiler(XLEN xlen)
+    : m_XLEN(xlen)
+{
+}
+
+JitCompiler::~JitCompiler()
+{
+    if (m_pCodeBuffer == nullptr)
+    {
+        return;
+    }
+
+#ifdef WIN32
+    VirtualFree(m_pCodeBuffer, 0, MEM_RELEASE);
+#else
+    munmap(m_pCodeBuffer, CodeBufferSize);
+#endif
+}
+
+bool JitCompiler::IsHostSupported()
+{
+#if defined(__x86_64__) || defined(_M_X64)
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool JitCompiler::CompileBasicBlock(BasicBlock* pBlock)
+{
+    auto& ops = pBlock->ops;
+
+    for (size_t index = 0; index < ops.size(); )
+    {
+        if (!IsCompilable(ops[index].op))
+        {
+            index++;
+            continue;
+        }
+
+        JitRun run;
+
+        auto end = index;
+        while (end < ops.size() && IsCompilable(ops[end].op))
+        {
+            const auto& op = ops[end].op;
+
+            run.opCount++;
+            run.size += ops[end].size;
+            run.cancelReservation |= (op.opClass == OpClass::RV32M || op.opClass == OpClass::RV64M);
+
+            end++;
+
+            if (IsRunEnd(op))
+            {
+                run.cancelReservationIfTaken = op.opCode != OpCode::jal && std::get<OperandB>(op.operand).imm < 0;
+                break;
+            }
+        }
+
+        if (run.opCount >= MinRunOpCount)
+        {
+            run.function = Compile(*pBlock, index, end - index);
+            if (run.function == nullptr)
+            {
+                MakeCodeBufferExecutable();
+                return false;
+            }
+
+            ops[index].jitRun = run;
+        }
+
+        index = end;
+    }
+
+    MakeCodeBufferExecutable();
+
+    pBlock->compiled = true;
+    return true;
+}
+
+void JitCompiler::Reset()
+{
+    m_CodeBufferUsed = 0;
+}
+
+bool JitCompiler::IsCompilable(const Op& op) const
+{
+    switch (op.opClass)
+    {
+    case OpClass::RV32I:
+    case OpClass::RV64I:
+        switch (op.opCode)
+        {
+        case OpCode::lui:
+        case OpCode::auipc:
+        case OpCode::jal:
+        case OpCode::beq:
+        case OpCode::bne:
+        case OpCode::blt:
+        case OpCode::bge:
+        case OpCode::bltu:
+        case OpCode::bgeu:
+        case OpCode::addi:
+        case OpCode::addiw:
+        case OpCode::slti:
+        case OpCode::sltiu:
+        case OpCode::xori:
+        case OpCode::ori:
+        case OpCode::andi:
+        case OpCode::slli:
+        case OpCode::slliw:
+        case OpCode::srli:
+        case OpCode::srliw:
+        case OpCode::srai:
+        case OpCode::sraiw:
+        case OpCode::add:
+        case OpCode::addw:
+        case OpCode::sub:
+        case OpCode::subw:
+        case OpCode::sll:
+        case OpCode::sllw:
+        case OpCode::slt:
+        case OpCode::sltu:
+        case OpCode::xor_:
+        case OpCode::srl:
+        case OpCode::srlw:
+        case OpCode::sra:
+        case OpCode::sraw:
+        case OpCode::or_:
+        case OpCode::and_:
+            return true;
+        default:
+            return false;
+        }
+    case OpClass::RV32M:
+    case OpClass::RV64M:
+        // div and rem are left to Executor to handle division by zero and overflow.
+        switch (op.opCode)
+        {
+        case OpCode::mul:
+        case OpCode::mulh:
+        case OpCode::mulhsu:
+        case OpCode::mulhu:
+        case OpCode::mulw:
+            return true;
+        default:
+            return false;
+        }
+    default:
+        return false;
+    }
+}
+
+bool JitCompiler::IsRunEnd(const Op& op) const
+{
+    switch (op.opCode)
+    {
+    case OpCode::jal:
+    case OpCode::beq:
+    case OpCode::bne:
+    case OpCode::blt:
+    case OpCode::bge:
+    case OpCode::bltu:
+    case OpCode::bgeu:
+        return true;
+    default:
+        return false;
+    }
+}
+
+bool JitCompiler::IsWordOp(const Op& op) const
+{
+    switch (op.opCode)
+    {
+    case OpCode::addiw:
+    case OpCode::slliw:
+    case OpCode::srliw:
+    case OpCode::sraiw:
+    case OpCode::addw:
+    case OpCode::subw:
+    case OpCode::sllw:
+    case OpCode::srlw:
+    case OpCode::sraw:
+    case OpCode::mulw:
+        return true;
+    default:
+        return false;
+    }
+}
+
+JitFunction JitCompiler::Compile(const BasicBlock& block, size_t index, size_t count)
+{
+    m_Code.clear();
+
+    // Move arguments to registers which are volatile and not used for arguments.
+#ifdef WIN32
+    EmitRegReg(true, { 0x8b }, RegIntRegs, Rcx);
+    EmitRegReg(true, { 0x8b }, RegPc, Rdx);
+#else
+    EmitRegReg(true, { 0x8b }, RegIntRegs, Rdi);
+    EmitRegReg(true, { 0x8b }, RegPc, Rsi);
+#endif
+
+    int32_t offset = 0;
+
+    for (auto i = index; i < index + count; i++)
+    {
+        const auto& entry = block.ops[i];
+
+        CompileOp(entry.op, offset, entry.size);
+        offset += entry.size;
+    }
+
+    if (!IsRunEnd(block.ops[index + count - 1].op))
+    {
+        EmitLeaPc(Rax, offset);
+        EmitRet();
+    }
+
+    AllocateCodeBuffer();
+
+    if (m_CodeBufferUsed + m_Code.size() > CodeBufferSize)
+    {
+        return nullptr;
+    }
+
+    MakeCodeBufferWritable();
+
+    auto pCode = m_pCodeBuffer + m_CodeBufferUsed;
+
+    std::memcpy(pCode, m_Code.data(), m_Code.size());
+    m_CodeBufferUsed += m_Code.size();
+
+    return reinterpret_cast<JitFunction>(pCode);
+}
+
+void JitCompiler::AllocateCodeBuffer()
+{
+    if (m_pCodeBuffer != nullptr)
+    {
+        return;
+    }
+
+#ifdef WIN32
+    m_pCodeBuffer = static_cast<uint8_t*>(VirtualAlloc(nullptr, CodeBufferSize, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE));
+#else
+    void* p = mmap(nullptr, CodeBufferSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    m_pCodeBuffer = (p == MAP_FAILED) ? nullptr : static_cast<uint8_t*>(p);
+#endif
+    if (m_pCodeBuffer == nullptr)
+    {
+        RAFI_EMU_ERROR("Failed to allocate code buffer for jit.\n");
+    }
+
+    m_WritableOffset = 0;
+}
+
+// Pages before m_CodeBufferUsed which are not written any more stay executable.
+void JitCompiler::MakeCodeBufferWritable()
+{
+    const auto offset = m_CodeBufferUsed / GetPageSize() * GetPageSize();
+
+    if (offset >= m_WritableOffset)
+    {
+        return;
+    }
+
+#ifdef WIN32
+    DWORD oldProtect;
+    if (!VirtualProtect(m_pCodeBuffer + offset, CodeBufferSize - offset, PAGE_READWRITE, &oldProtect))
+#else
+    if (mprotect(m_pCodeBuffer + offset, CodeBufferSize - offset, PROT_READ | PROT_WRITE) != 0)
+#endif
+    {
+        RAFI_EMU_ERROR("Failed to make code buffer for jit writable.\n");
+    }
+
+    m_WritableOffset = offset;
+}
+
+void JitCompiler::MakeCodeBufferExecutable()
+{
+    if (m_WritableOffset >= CodeBufferSize)
+    {
+        return;
+    }
+
+#ifdef WIN32
+    DWORD oldProtect;
+    if (!VirtualProtect(m_pCodeBuffer + m_WritableOffset, CodeBufferSize - m_WritableOffset, PAGE_EXECUTE_READ, &oldProtect))
+#else
+    if (mprotect(m_pCodeBuffer + m_WritableOffset, CodeBufferSize - m_WritableOffset, PROT_READ | PROT_EXEC) != 0)
+#endif
+    {
+        RAFI_EMU_ERROR("Failed to make code buffer for jit executable.\n");
+    }
+
+    m_WritableOffset = CodeBufferSize;
+}
+
+void JitCompiler::CompileOp(const Op& op, int32_t offset, int size)
+{
+    switch (op.opCode)
+    {
+    case OpCode::lui:
+        CompileLui(op);
+        break;
+    case OpCode::auipc:
+        CompileAuipc(op, offset);
+        break;
+    case OpCode::jal:
+        CompileJal(op, offset);
+        break;
+    case OpCode::beq:
+    case OpCode::bne:
+    case OpCode::blt:
+    case OpCode::bge:
+    case OpCode::bltu:
+    case OpCode::bgeu:
+        CompileBranch(op, offset, size);
+        break;
+    case OpCode::addi:
+    case OpCode::addiw:
+    case OpCode::slti:
+    case OpCode::sltiu:
+    case OpCode::xori:
+    case OpCode::ori:
+    case OpCode::andi:
+        CompileAluImm(op);
+        break;
+    case OpCode::slli:
+    case OpCode::slliw:
+    case OpCode::srli:
+    case OpCode::srliw:
+    case OpCode::srai:
+    case OpCode::sraiw:
+        CompileShiftImm(op);
+        break;
+    case OpCode::add:
+    case OpCode::addw:
+    case OpCode::sub:
+    case OpCode::subw:
+    case OpCode::slt:
+    case OpCode::sltu:
+    case OpCode::xor_:
+    case OpCode::or_:
+    case OpCode::and_:
+        CompileAlu(op);
+        break;
+    case OpCode::sll:
+    case OpCode::sllw:
+    case OpCode::srl:
+    case OpCode::srlw:
+    case OpCode::sra:
+    case OpCode::sraw:
+        CompileShift(op);
+        break;
+    case OpCode::mul:
+    case OpCode::mulh:
+    case OpCode::mulhsu:
+    case OpCode::mulhu:
+    case OpCode::mulw:
+        CompileMul(op);
+        break;
+    default:
+        RAFI_EMU_NOT_IMPLEMENTED;
+    }
+}
+
+void JitCompiler::CompileLui(const Op& op)
+{
+    const auto& operand = std::get<OperandU>(op.operand);
+
+    EmitMovImm(Rax, operand.imm);
+    StoreResult(operand.rd, false);
+}
+
+void JitCompiler::CompileAuipc(const Op& op, int32_t offset)
+{
+    const auto& operand = std::get<OperandU>(op.operand);
+
+    const int64_t value = offset + operand.imm;
+
+    if (IsInt32(value))
+    {
+        EmitLeaPc(Rax, static_cast<int32_t>(value));
+    }
+    else
+    {
+        EmitMovImm(Rax, value);
+        EmitRegReg(true, { 0x03 }, Rax, RegPc);
+    }
+
+    StoreResult(operand.rd, false);
+}
+
+void JitCompiler::CompileAlu(const Op& op)
+{
+    const auto& operand = std::get<OperandR>(op.operand);
+
+    const bool word = IsWordOp(op);
+    const bool is64 = m_XLEN == XLEN::XLEN64 && !word;
+    const int32_t src2 = operand.rs2 * sizeof(uint64_t);
+
+    LoadIntReg(Rax, operand.rs1, is64);
+
+    switch (op.opCode)
+    {
+    case OpCode::add:
+    case OpCode::addw:
+        EmitRegMem(is64, { 0x03 }, Rax, RegIntRegs, src2);
+        break;
+    case OpCode::sub:
+    case OpCode::subw:
+        EmitRegMem(is64, { 0x2b }, Rax, RegIntRegs, src2);
+        break;
+    case OpCode::slt:
+        EmitRegMem(is64, { 0x3b }, Rax, RegIntRegs, src2);
+        EmitSetcc(ConditionL);
+        break;
+    case OpCode::sltu:
+        EmitRegMem(is64, { 0x3b }, Rax, RegIntRegs, src2);
+        EmitSetcc(ConditionB);
+        break;
+    case OpCode::xor_:
+        EmitRegMem(is64, { 0x33 }, Rax, RegIntRegs, src2);
+        break;
+    case OpCode::or_:
+        EmitRegMem(is64, { 0x0b }, Rax, RegIntRegs, src2);
+        break;
+    case OpCode::and_:
+        EmitRegMem(is64, { 0x23 }, Rax, RegIntRegs, src2);
+        break;
+    default:
+        RAFI_EMU_NOT_IMPLEMENTED;
+    }
+
+    StoreResult(operand.rd, word);
+}
+
+void JitCompiler::CompileAluImm(const Op& op)
+{
+    const auto& operand = std::get<OperandI>(op.operand);
+
+    const bool word = IsWordOp(op);
+    const bool is64 = m_XLEN == XLEN::XLEN64 && !word;
+    const auto imm = static_cast<int32_t>(operand.imm);
+
+    LoadIntReg(Rax, operand.rs1, is64);
+
+    switch (op.opCode)
+    {
+    case OpCode::addi:
+    case OpCode::addiw:
+        EmitRegImm(is64, ExtAdd, Rax, imm);
+        break;
+    case OpCode::slti:
+        EmitRegImm(is64, ExtCmp, Rax, imm);
+        EmitSetcc(ConditionL);
+        break;
+    case OpCode::sltiu:
+        EmitRegImm(is64, ExtCmp, Rax, imm);
+        EmitSetcc(ConditionB);
+        break;
+    case OpCode::xori:
+        EmitRegImm(is64, ExtXor, Rax, imm);
+        break;
+    case OpCode::ori:
+        EmitRegImm(is64, ExtOr, Rax, imm);
+        break;
+    case OpCode::andi:
+        EmitRegImm(is64, ExtAnd, Rax, imm);
+        break;
+    default:
+        RAFI_EMU_NOT_IMPLEMENTED;
+    }
+
+    StoreResult(operand.rd, word);
+}
+
+void JitCompiler::CompileShift(const Op& op)
+{
+    const auto& operand = std::get<OperandR>(op.operand);
+
+    const bool word = IsWordOp(op);
+    const bool is64 = m_XLEN == XLEN::XLEN64 && !word;
+
+    uint8_t extension;
+
+    switch (op.opCode)
+    {
+    case OpCode::sll:
+    case OpCode::sllw:
+        extension = ExtShl;
+        break;
+    case OpCode::srl:
+    case OpCode::srlw:
+        extension = ExtShr;
+        break;
+    case OpCode::sra:
+    case OpCode::sraw:
+        extension = ExtSar;
+        break;
+    default:
+        RAFI_EMU_NOT_IMPLEMENTED;
+    }
+
+    // x86 masks shift amount in cl by operand size as RISC-V does.
+    LoadIntReg(Rax, operand.rs1, is64);
+    LoadIntReg(Rcx, operand.rs2, false);
+    EmitRegReg(is64, { 0xd3 }, extension, Rax);
+
+    StoreResult(operand.rd, word);
+}
+
+void JitCompiler::CompileShiftImm(const Op& op)
+{
+    const auto& operand = std::get<OperandShiftImm>(op.operand);
+
+    const bool word = IsWordOp(op);
+    const bool is64 = m_XLEN == XLEN::XLEN64 && !word;
+
+    uint8_t extension;
+
+    switch (op.opCode)
+    {
+    case OpCode::slli:
+    case OpCode::slliw:
+        extension = ExtShl;
+        break;
+    case OpCode::srli:
+    case OpCode::srliw:
+        extension = ExtShr;
+        break;
+    case OpCode::srai:
+    case OpCode::sraiw:
+        extension = ExtSar;
+        break;
+    default:
+        RAFI_EMU_NOT_IMPLEMENTED;
+    }
+
+    LoadIntReg(Rax, operand.rs1, is64);
+    EmitShiftImm(is64, extension, Rax, operand.shamt);
+
+    StoreResult(operand.rd, word);
+}
+
+void JitCompiler::CompileMul(const Op& op)
+{
+    const auto& operand = std::get<OperandR>(op.operand);
+
+    const bool word = IsWordOp(op);
+    const int32_t src1 = operand.rs1 * sizeof(uint64_t);
+    const int32_t src2 = operand.rs2 * sizeof(uint64_t);
+
+    if (op.opCode == OpCode::mul || op.opCode == OpCode::mulw)
+    {
+        const bool is64 = m_XLEN == XLEN::XLEN64 && !word;
+
+        LoadIntReg(Rax, operand.rs1, is64);
+        EmitRegMem(is64, { 0x0f, 0xaf }, Rax, RegIntRegs, src2);
+    }
+    else if (m_XLEN == XLEN::XLEN64)
+    {
+        // rdx:rax = rax * src2
+        LoadIntReg(Rax, operand.rs1, true);
+        if (op.opCode == OpCode::mulhsu)
+        {
+            EmitRegReg(true, { 0x8b }, Rcx, Rax);
+        }
+
+        EmitRegMem(true, { 0xf7 }, op.opCode == OpCode::mulh ? ExtImul : ExtMul, RegIntRegs, src2);
+
+        if (op.opCode == OpCode::mulhsu)
+        {
+            // Unsigned high part minus src2 if src1 is negative
+            EmitShiftImm(true, ExtSar, Rcx, 63);
+            EmitRegMem(true, { 0x23 }, Rcx, RegIntRegs, src2);
+            EmitRegReg(true, { 0x2b }, Rdx, Rcx);
+        }
+
+        EmitRegReg(true, { 0x8b }, Rax, Rdx);
+    }
+    else
+    {
+        // 64-bit product of sign or zero extended sources
+        if (op.opCode == OpCode::mulhu)
+        {
+            EmitRegMem(false, { 0x8b }, Rax, RegIntRegs, src1);
+        }
+        else
+        {
+            EmitRegMem(true, { 0x63 }, Rax, RegIntRegs, src1);
+        }
+
+        if (op.opCode == OpCode::mulh)
+        {
+            EmitRegMem(true, { 0x63 }, Rcx, RegIntRegs, src2);
+        }
+        else
+        {
+            EmitRegMem(false, { 0x8b }, Rcx, RegIntRegs, src2);
+        }
+
+        EmitRegReg(true, { 0x0f, 0xaf }, Rax, Rcx);
+        EmitShiftImm(true, ExtShr, Rax, 32);
+    }
+
+    StoreResult(operand.rd, word);
+}
+
+void JitCompiler::CompileBranch(const Op& op, int32_t offset, int size)
+{
+    const auto& operand = std::get<OperandB>(op.operand);
+
+    const bool is64 = m_XLEN == XLEN::XLEN64;
+
+    uint8_t condition;
+
+    switch (op.opCode)
+    {
+    case OpCode::beq:
+        condition = ConditionE;
+        break;
+    case OpCode::bne:
+        condition = ConditionNE;
+        break;
+    case OpCode::blt:
+        condition = ConditionL;
+        break;
+    case OpCode::bge:
+        condition = ConditionGE;
+        break;
+    case OpCode::bltu:
+        condition = ConditionB;
+        break;
+    case OpCode::bgeu:
+        condition = ConditionAE;
+        break;
+    default:
+        RAFI_EMU_NOT_IMPLEMENTED;
+    }
+
+    LoadIntReg(Rax, operand.rs1, is64);
+    EmitRegMem(is64, { 0x3b }, Rax, RegIntRegs, operand.rs2 * sizeof(uint64_t));
+
+    // jcc rel8 to the taken path
+    Emit8(0x70 | condition);
+    const auto jumpOffsetPosition = m_Code.size();
+    Emit8(0);
+
+    EmitLeaPc(Rax, offset + size);
+    EmitRet();
+
+    m_Code[jumpOffsetPosition] = static_cast<uint8_t>(m_Code.size() - jumpOffsetPosition - 1);
+
+    EmitLeaPc(Rax, static_cast<int32_t>(offset + operand.imm));
+    EmitRet();
+}
+
+void JitCompiler::CompileJal(const Op& op, int32_t offset)
+{
+    const auto& operand = std::get<OperandJ>(op.operand);
+
+    if (operand.rd != 0)
+    {
+        EmitLeaPc(Rax, offset + 4);
+        StoreResult(operand.rd, false);
+    }
+
+    EmitLeaPc(Rax, static_cast<int32_t>(offset + operand.imm));
+    EmitRet();
+}
+
+void JitCompiler::StoreResult(int rd, bool signExtendWord)
+{
+    // Same as IntRegFile, x0 is not written and RV32 writes lower 32 bits only.
+    if (rd == 0)
+    {
+        return;
+    }
+
+    if (signExtendWord)
+    {
+        EmitSignExtendWord();
+    }
+
+    EmitRegMem(m_XLEN == XLEN::XLEN64, { 0x89 }, Rax, RegIntRegs, rd * sizeof(uint64_t));
+}
+
+void JitCompiler::LoadIntReg(HostReg reg, int regId, bool is64)
+{
+    EmitRegMem(is64, { 0x8b }, reg, RegIntRegs, regId * sizeof(uint64_t));
+}
+
+void JitCompiler::Emit8(uint8_t value)
+{
+    m_Code.push_back(value);
+}
+
+void JitCompiler::Emit32(uint32_t value)
+{
+    for (int i = 0; i < 4; i++)
+    {
+        Emit8(static_cast<uint8_t>(value >> (i * 8)));
+    }
+}
+
+void JitCompiler::Emit64(uint64_t value)
+{
+    for (int i = 0; i < 8; i++)
+    {
+        Emit8(static_cast<uint8_t>(value >> (i * 8)));
+    }
+}
+
+void JitCompiler::EmitRex(bool is64, int reg, int rm)
+{
+    const uint8_t rex = 0x40 | (is64 ? 0x8 : 0) | ((reg & 0x8) >> 1) | ((rm & 0x8) >> 3);
+
+    if (rex != 0x40)
+    {
+        Emit8(rex);
+    }
+}
+
+void JitCompiler::EmitRegReg(bool is64, std::initializer_list<uint8_t> opcode, int reg, int rm)
+{
+    EmitRex(is64, reg, rm);
+
+    for (const auto value: opcode)
+    {
+        Emit8(value);
+    }
+
+    Emit8(0xc0 | ((reg & 0x7) << 3) | (rm & 0x7));
+}
+
+void JitCompiler::EmitRegMem(bool is64, std::initializer_list<uint8_t> opcode, int reg, HostReg base, int32_t disp)
+{
+    EmitRex(is64, reg, base);
+
+    for (const auto value: opcode)
+    {
+        Emit8(value);
+    }
+
+    // base is neither rsp nor r12, so SIB byte is not needed.
+    if (INT8_MIN <= disp && disp <= INT8_MAX)
+    {
+        Emit8(0x40 | ((reg & 0x7) << 3) | (base & 0x7));
+        Emit8(static_cast<uint8_t>(disp));
+    }
+    else
+    {
+        Emit8(0x80 | ((reg & 0x7) << 3) | (base & 0x7));
+        Emit32(static_cast<uint32_t>(disp));
+    }
+}
+
+void JitCompiler::EmitRegImm(bool is64, uint8_t extension, HostReg reg, int32_t imm)
+{
+    EmitRegReg(is64, { 0x81 }, extension, reg);
+    Emit32(static_cast<uint32_t>(imm));
+}
+
+void JitCompiler::EmitMovImm(HostReg reg, int64_t imm)
+{
+    if (IsInt32(imm))
+    {
+        EmitRegReg(true, { 0xc7 }, 0, reg);
+        Emit32(static_cast<uint32_t>(imm));
+    }
+    else
+    {
+        EmitRex(true, 0, reg);
+        Emit8(0xb8 | (reg & 0x7));
+        Emit64(static_cast<uint64_t>(imm));
+    }
+}
+
+void JitCompiler::EmitLeaPc(HostReg reg, int32_t offset)
+{
+    EmitRegMem(true, { 0x8d }, reg, RegPc, offset);
+}
+
+void JitCompiler::EmitShiftImm(bool is64, uint8_t extension, HostReg reg, int shamt)
+{
+    EmitRegReg(is64, { 0xc1 }, extension, reg);
+    Emit8(static_cast<uint8_t>(shamt));
+}
+
+void JitCompiler::EmitSetcc(uint8_t condition)
+{
+    // setcc al; movzx eax, al
+    EmitRegReg(false, { 0x0f, static_cast<uint8_t>(0x90 | condition) }, 0, Rax);
+    EmitRegReg(false, { 0x0f, 0xb6 }, Rax, Rax);
+}
+
+void JitCompiler::EmitSignExtendWord()
+{
+    // movsxd rax, eax
+    EmitRegReg(true, { 0x63 }, Rax, Rax);
+}
+
+void JitCompiler::EmitRet()
+{
+    Emit8(0xc3);
+}
+
+}}}
@@ -0,0 +1,131 @@
+/*
+ * Copyright 2018 Akifumi Fujita
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <initializer_list>
+#include <vector>
+
+#include <rafi/common.h>
+#include <rafi/emu.h>
+
+namespace rafi { namespace emu { namespace cpu {
+
+struct BasicBlock;
+
+// Host code for consecutive ops. Takes the int register file and the virtual pc of the first op, and returns the next pc.
+using JitFunction = uint64_t (*)(void* pIntRegs, uint64_t pc);
+
+struct JitRun
+{
+    JitFunction function{ nullptr };
+    int opCount{ 0 };
+    int size{ 0 };
+
+    // Same as Executor, m ops and taken backward branches cancel the reservation of lr.
+    bool cancelReservation{ false };
+    bool cancelReservationIfTaken{ false };
+};
+
+// Compiles runs of integer ops (RV32I, RV64I and mul ops of RV32M, RV64M) in a basic block to x86-64 code.
+// Other ops, including loads, stores, csr ops and compressed ops, are processed by Executor.
+class JitCompiler final
+{
+public:
+    explicit JitCompiler(XLEN xlen);
+    ~JitCompiler();
+
+    static bool IsHostSupported();
+
+    // Compiles all runs in the block. Returns false if the code buffer is full.
+    bool CompileBasicBlock(BasicBlock* pBlock);
+
+    // Discards all compiled code. Runs compiled before that must not be used.
+    void Reset();
+
+private:
+    static const size_t CodeBufferSize = 16 * 1024 * 1024;
+    static const int MinRunOpCount = 2;
+
+    enum HostReg
+    {
+        Rax = 0,
+        Rcx = 1,
+        Rdx = 2,
+        Rsi = 6,
+        Rdi = 7,
+        R8 = 8,
+        R9 = 9,
+    };
+
+    // Generated code uses only volatile registers, so it needs no stack frame.
+    static const HostReg RegIntRegs = R8;
+    static const HostReg RegPc = R9;
+
+    bool IsCompilable(const Op& op) const;
+    bool IsRunEnd(const Op& op) const;
+    bool IsWordOp(const Op& op) const;
+
+    JitFunction Compile(const BasicBlock& block, size_t index, size_t count);
+
+    // Code buffer is writable only while a block is compiled, and executable otherwise.
+    void AllocateCodeBuffer();
+    void MakeCodeBufferWritable();
+    void MakeCodeBufferExecutable();
+
+    void CompileOp(const Op& op, int32_t offset, int size);
+    void CompileLui(const Op& op);
+    void CompileAuipc(const Op& op, int32_t offset);
+    void CompileAlu(const Op& op);
+    void CompileAluImm(const Op& op);
+    void CompileShift(const Op& op);
+    void CompileShiftImm(const Op& op);
+    void CompileMul(const Op& op);
+    void CompileBranch(const Op& op, int32_t offset, int size);
+    void CompileJal(const Op& op, int32_t offset);
+
+    // rax -> int reg
+    void StoreResult(int rd, bool signExtendWord);
+    void LoadIntReg(HostReg reg, int regId, bool is64);
+
+    // Emitter
+    void Emit8(uint8_t value);
+    void Emit32(uint32_t value);
+    void Emit64(uint64_t value);
+    void EmitRex(bool is64, int reg, int rm);
+    void EmitRegReg(bool is64, std::initializer_list<uint8_t> opcode, int reg, int rm);
+    void EmitRegMem(bool is64, std::initializer_list<uint8_t> opcode, int reg, HostReg base, int32_t disp);
+    void EmitRegImm(bool is64, uint8_t extension, HostReg reg, int32_t imm);
+    void EmitMovImm(HostReg reg, int64_t imm);
+    void EmitLeaPc(HostReg reg, int32_t offset);
+    void EmitShiftImm(bool is64, uint8_t extension, HostReg reg, int shamt);
+    void EmitSetcc(uint8_t condition);
+    void EmitSignExtendWord();
+    void EmitRet();
+
+    XLEN m_XLEN;
+
+    uint8_t* m_pCodeBuffer{ nullptr };
+    size_t m_CodeBufferUsed{ 0 };
+
+    // Start of the pages which are writable now. CodeBufferSize if the buffer is not writable.
+    size_t m_WritableOffset{ CodeBufferSize };
+
+    std::vector<uint8_t> m_Code;
+};
+
+}}}
@@ -26,7 +26,6 @@ namespace rafi { namespace emu { namespace cpu {
 MemoryAccessUnit::MemoryAccessUnit(XLEN xlen)
     : m_XLEN(xlen)
 {
-    m_Events.clear();
 }
 
 void MemoryAccessUnit::Initialize(bus::Bus* pBus, Csr* pCsr)
@@ -133,11 +132,65 @@ uint32_t MemoryAccessUnit::FetchUInt32(vaddr_t vaddr, paddr_t paddr)
     return value;
 }
 
+template <XLEN xlen>
+AddressTranslationMode MemoryAccessUnit::GetAddresssTranslationMode(MemoryAccessType accessType) const
+{
+    if (GetEffectivePrivilegeLevel(accessType) == PrivilegeLevel::Machine)
+    {
+        return AddressTranslationMode::Bare;
+    }
+
+    const auto satp = m_pCsr->ReadSatp();
+
+    if constexpr (xlen == XLEN::XLEN32)
+    {
+        return static_cast<AddressTranslationMode>(satp.GetMember<satp_t::MODE_RV32>());
+    }
+    else
+    {
+        return static_cast<AddressTranslationMode>(satp.GetMember<satp_t::MODE_RV64>());
+    }
+}
+
 std::optional<Trap> MemoryAccessUnit::CheckTrap(MemoryAccessType accessType, vaddr_t pc, vaddr_t addr) const
+{
+    switch (m_XLEN)
+    {
+    case XLEN::XLEN32:
+        return CheckTrapImpl<XLEN::XLEN32>(accessType, pc, addr);
+    case XLEN::XLEN64:
+        return CheckTrapImpl<XLEN::XLEN64>(accessType, pc, addr);
+    default:
+        RAFI_EMU_NOT_IMPLEMENTED;
+    }
+}
+
+std::optional<Trap> MemoryAccessUnit::Translate(paddr_t* pOutAddr, MemoryAccessType accessType, vaddr_t addr, vaddr_t pc)
+{
+    switch (m_XLEN)
+    {
+    case XLEN::XLEN32:
+        return TranslateImpl<XLEN::XLEN32>(pOutAddr, accessType, addr, pc);
+    case XLEN::XLEN64:
+        return TranslateImpl<XLEN::XLEN64>(pOutAddr, accessType, addr, pc);
+    default:
+        RAFI_EMU_NOT_IMPLEMENTED;
+    }
+}
+
+template <XLEN xlen>
+std::optional<Trap> MemoryAccessUnit::CheckTrapImpl(MemoryAccessType accessType, vaddr_t pc, vaddr_t addr) const
 {
     // TODO: Implement Physical Memory Protection (PMP)
 
-    switch (GetAddresssTranslationMode(accessType))
+    const auto mode = GetAddresssTranslationMode<xlen>(accessType);
+
+    if (mode != AddressTranslationMode::Bare && IsTlbHit(accessType, addr))
+    {
+        return std::nullopt;
+    }
+
+    switch (mode)
     {
     case AddressTranslationMode::Bare:
         return std::nullopt;
@@ -156,14 +209,38 @@ std::optional<Trap> MemoryAccessUnit::CheckTrap(MemoryAccessType accessType, vad
     }
 }
 
+void MemoryAccessUnit::FlushTlb()
+{
+    m_InstructionTlb.Flush();
+    m_DataTlb.Flush();
+
+    m_TlbGeneration = m_pCsr->GetTranslationGeneration();
+}
+
+void MemoryAccessUnit::SetEventEnabled(bool enabled)
+{
+    m_EventEnabled = enabled;
+    m_EventCount = 0;
+}
+
 void MemoryAccessUnit::AddEvent(MemoryAccessType accessType, int size, uint64_t value, vaddr_t vaddr, paddr_t paddr)
 {
-    m_Events.push_back({ accessType, static_cast<uint32_t>(size), value, vaddr, paddr });
+    if (!m_EventEnabled)
+    {
+        return;
+    }
+
+    if (m_EventCount >= MaxEventCount)
+    {
+        RAFI_EMU_ERROR("Too many memory access events in a cycle.\n");
+    }
+
+    m_Events[m_EventCount++] = { accessType, static_cast<uint32_t>(size), value, vaddr, paddr };
 }
 
 void MemoryAccessUnit::ClearEvent()
 {
-    m_Events.clear();
+    m_EventCount = 0;
 }
 
 void MemoryAccessUnit::CopyEvent(MemoryAccessEvent* pOut, int index) const
@@ -173,7 +250,7 @@ void MemoryAccessUnit::CopyEvent(MemoryAccessEvent* pOut, int index) const
 
 size_t MemoryAccessUnit::GetEventCount() const
 {
-    return m_Events.size();
+    return static_cast<size_t>(m_EventCount);
 }
 
 PrivilegeLevel MemoryAccessUnit::GetEffectivePrivilegeLevel(MemoryAccessType accessType) const
@@ -191,24 +268,18 @@ PrivilegeLevel MemoryAccessUnit::GetEffectivePrivilegeLevel(MemoryAccessType acc
     }
 }
 
-AddressTranslationMode MemoryAccessUnit::GetAddresssTranslationMode(MemoryAccessType accessType) const
+
+bool MemoryAccessUnit::IsTlbHit(MemoryAccessType accessType, vaddr_t addr) const
 {
-    if (GetEffectivePrivilegeLevel(accessType) == PrivilegeLevel::Machine)
+    if (m_TlbGeneration != m_pCsr->GetTranslationGeneration())
     {
-        return AddressTranslationMode::Bare;
+        return false;
     }
 
-    const auto satp = m_pCsr->ReadSatp();
+    const auto& tlb = (accessType == MemoryAccessType::Instruction) ? m_InstructionTlb : m_DataTlb;
 
-    switch (m_XLEN)
-    {
-    case XLEN::XLEN32:
-        return static_cast<AddressTranslationMode>(satp.GetMember<satp_t::MODE_RV32>());
-    case XLEN::XLEN64:
-        return static_cast<AddressTranslationMode>(satp.GetMember<satp_t::MODE_RV64>());
-    default:
-        RAFI_EMU_NOT_IMPLEMENTED;
-    }
+    paddr_t paddr;
+    return tlb.Find(&paddr, addr, GetEffectivePrivilegeLevel(accessType), accessType);
 }
 
 std::optional<Trap> MemoryAccessUnit::CheckTrapSv32(MemoryAccessType accessType, vaddr_t pc, vaddr_t addr) const
@@ -410,26 +481,61 @@ std::optional<Trap> MemoryAccessUnit::MakeTrap(MemoryAccessType accessType, vadd
     }
 }
 
-std::optional<Trap> MemoryAccessUnit::Translate(paddr_t* pOutAddr, MemoryAccessType accessType, vaddr_t addr, vaddr_t pc)
+template <XLEN xlen>
+std::optional<Trap> MemoryAccessUnit::TranslateImpl(paddr_t* pOutAddr, MemoryAccessType accessType, vaddr_t addr, vaddr_t pc)
 {
-    switch (GetAddresssTranslationMode(accessType))
+    const auto mode = GetAddresssTranslationMode<xlen>(accessType);
+
+    if (mode == AddressTranslationMode::Bare)
     {
-    case AddressTranslationMode::Bare:
-        *pOutAddr = (m_XLEN == XLEN::XLEN32) ? ZeroExtend(32, addr) : static_cast<paddr_t>(addr);
+        if constexpr (xlen == XLEN::XLEN32)
+        {
+            *pOutAddr = ZeroExtend(32, addr);
+        }
+        else
+        {
+            *pOutAddr = static_cast<paddr_t>(addr);
+        }
         return std::nullopt;
+    }
+
+    if (m_TlbGeneration != m_pCsr->GetTranslationGeneration())
+    {
+        FlushTlb();
+    }
+
+    const auto privilegeLevel = GetEffectivePrivilegeLevel(accessType);
+    auto& tlb = (accessType == MemoryAccessType::Instruction) ? m_InstructionTlb : m_DataTlb;
+
+    if (tlb.Find(pOutAddr, addr, privilegeLevel, accessType))
+    {
+        return std::nullopt;
+    }
+
+    // A and D bits are updated by page walk, so a hit for store means that D bit has been set.
+    switch (mode)
+    {
     case AddressTranslationMode::Sv32:
-        return TranslateSv32(pOutAddr, accessType, addr, pc);
+        RAFI_RETURN_IF_TRAP(TranslateSv32(pOutAddr, accessType, addr, pc));
+        break;
     case AddressTranslationMode::Sv39:
-        return TranslateSv39(pOutAddr, accessType, addr, pc);
+        RAFI_RETURN_IF_TRAP(TranslateSv39(pOutAddr, accessType, addr, pc));
+        break;
     case AddressTranslationMode::Sv48:
-        return TranslateSv48(pOutAddr, accessType, addr, pc);
+        RAFI_RETURN_IF_TRAP(TranslateSv48(pOutAddr, accessType, addr, pc));
+        break;
     case AddressTranslationMode::Sv57:
-        return TranslateSv57(pOutAddr, accessType, addr, pc);
+        RAFI_RETURN_IF_TRAP(TranslateSv57(pOutAddr, accessType, addr, pc));
+        break;
     case AddressTranslationMode::Sv64:
-        return TranslateSv64(pOutAddr, accessType, addr, pc);
+        RAFI_RETURN_IF_TRAP(TranslateSv64(pOutAddr, accessType, addr, pc));
+        break;
     default:
         RAFI_EMU_NOT_IMPLEMENTED;
     }
+
+    tlb.Insert(addr, *pOutAddr, privilegeLevel, accessType);
+    return std::nullopt;
 }
 
 std::optional<Trap> MemoryAccessUnit::TranslateSv32(paddr_t* pOutAddr, MemoryAccessType accessType, vaddr_t addr, vaddr_t pc)
@@ -18,13 +18,13 @@
 
 #include <cstdint>
 #include <cstring>
-#include <vector>
 
 #include <rafi/emu.h>
 
 #include "../bus/Bus.h"
 
 #include "Csr.h"
+#include "Tlb.h"
 
 namespace rafi { namespace emu { namespace cpu {
 
@@ -51,7 +51,12 @@ public:
     std::optional<Trap> CheckTrap(MemoryAccessType accessType, vaddr_t pc, vaddr_t addr) const;
     std::optional<Trap> Translate(paddr_t* pOutAddr, MemoryAccessType accessType, vaddr_t addr, vaddr_t pc = 0);
 
+    // for sfence.vma
+    void FlushTlb();
+
     // for Dump
+    void SetEventEnabled(bool enabled);
+
     void AddEvent(MemoryAccessType accessType, int size,  vaddr_t value, vaddr_t vaddr, paddr_t paddr);
     void ClearEvent();
 
@@ -61,8 +66,18 @@ public:
 private:
     PrivilegeLevel GetEffectivePrivilegeLevel(MemoryAccessType accessType) const;
 
+    // XLEN is fixed for the lifetime of the unit, so these are specialized for it at compile time.
+    template <XLEN xlen>
     AddressTranslationMode GetAddresssTranslationMode(MemoryAccessType accessType) const;
 
+    template <XLEN xlen>
+    std::optional<Trap> CheckTrapImpl(MemoryAccessType accessType, vaddr_t pc, vaddr_t addr) const;
+
+    template <XLEN xlen>
+    std::optional<Trap> TranslateImpl(paddr_t* pOutAddr, MemoryAccessType accessType, vaddr_t addr, vaddr_t pc);
+
+    bool IsTlbHit(MemoryAccessType accessType, vaddr_t addr) const;
+
     std::optional<Trap> CheckTrapSv32(MemoryAccessType accessType, vaddr_t pc, vaddr_t addr) const;
     std::optional<Trap> CheckTrapSv39(MemoryAccessType accessType, vaddr_t pc, vaddr_t addr) const;
     std::optional<Trap> CheckTrapSv48(MemoryAccessType accessType, vaddr_t pc, vaddr_t addr) const;
@@ -186,7 +201,18 @@ private:
 
     XLEN m_XLEN;
 
-    std::vector<MemoryAccessEvent> m_Events;
+    Tlb m_InstructionTlb;
+    Tlb m_DataTlb;
+
+    // Translation generation of Csr when TLBs are flushed
+    uint64_t m_TlbGeneration{ 0 };
+
+    // Events are recorded to a fixed buffer only while enabled (i.e. tracing)
+    static const int MaxEventCount = 8;
+
+    bool m_EventEnabled{ false };
+    int m_EventCount{ 0 };
+    MemoryAccessEvent m_Events[MaxEventCount];
 };
 
 }}}
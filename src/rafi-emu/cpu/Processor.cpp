@@ -28,14 +28,20 @@
 namespace rafi { namespace emu { namespace cpu {
 
 Processor::Processor(XLEN xlen, bus::Bus* pBus, vaddr_t initialPc)
-    : m_Csr(xlen, initialPc)
+    : m_pBus(pBus)
+    , m_Csr(xlen, initialPc)
     , m_InterruptController(&m_Csr)
     , m_TrapProcessor(xlen, &m_Csr)
     , m_Decoder(xlen)
     , m_MemAccessUnit(xlen)
-    , m_Executor(&m_AtomicManager, &m_Csr, &m_TrapProcessor, &m_IntRegFile, &m_FpRegFile, &m_MemAccessUnit)
+    , m_JitCompiler(xlen)
+    , m_Executor(&m_AtomicManager, &m_Csr, &m_TrapProcessor, &m_IntRegFile, &m_FpRegFile, &m_MemAccessUnit, &m_DecodeCache, &m_BasicBlockCache)
 {
     m_MemAccessUnit.Initialize(pBus, &m_Csr);
+    m_BasicBlockCache.Initialize(pBus, &m_Decoder, &m_Executor);
+
+    pBus->RegisterObserver(&m_DecodeCache);
+    pBus->RegisterObserver(&m_BasicBlockCache);
 }
 
 void Processor::RegisterExternalInterruptSource(IInterruptSource* pInterruptSource)
@@ -53,6 +59,25 @@ void Processor::SetIntReg(int regId, uint32_t regValue)
     m_IntRegFile.WriteUInt32(regId, regValue);
 }
 
+void Processor::SetBasicBlockEnabled(bool enabled)
+{
+    m_BasicBlockEnabled = enabled;
+    m_BasicBlockContinuable = false;
+}
+
+void Processor::SetJitEnabled(bool enabled)
+{
+    // Compiled runs are found from basic blocks.
+    m_JitEnabled = enabled && m_BasicBlockEnabled && JitCompiler::IsHostSupported();
+}
+
+void Processor::SetEventEnabled(bool enabled)
+{
+    m_EventEnabled = enabled;
+    m_OpEventValid = false;
+    m_MemAccessUnit.SetEventEnabled(enabled);
+}
+
 xip_t Processor::ReadInterruptPending() const
 {
     return m_Csr.ReadInterruptPending();
@@ -73,8 +98,26 @@ void Processor::WriteTime(uint64_t value)
     m_Csr.WriteTime(value);
 }
 
+void Processor::NotifyInterruptSourceChanged()
+{
+    m_InterruptController.NotifySourceChanged();
+}
+
+void Processor::InvalidateDecodeCache()
+{
+    m_DecodeCache.InvalidateAll();
+    m_BasicBlockCache.InvalidateAll();
+}
+
 void Processor::ProcessCycle()
 {
+    ProcessCycles(1);
+}
+
+int Processor::ProcessCycles(int maxCycleCount)
+{
+    m_WaitingForInterrupt = false;
+
     ClearOpEvent();
     m_TrapProcessor.ClearEvent();
     m_MemAccessUnit.ClearEvent();
@@ -94,29 +137,33 @@ void Processor::ProcessCycle()
         m_TrapProcessor.ProcessInterrupt(interruptType, pc);
 
         SetOpEvent(pc, privilegeLevel);
-        return;
+        m_BasicBlockContinuable = false;
+        return 1;
     }
 
-    // Fetch
+    // Fetch & Decode
+    Op op;
     uint32_t insn;
+    int insnSize;
+    Executor::Handler handler = &Executor::ProcessOp;
 
-    const auto fetchTrap = Fetch(&insn, pc);
+    const auto fetchTrap = m_BasicBlockEnabled
+        ? FetchFromBasicBlock(&op, &insn, &insnSize, &handler, pc)
+        : FetchAndDecode(&op, &insn, &insnSize, pc);
     if (fetchTrap)
     {
         m_TrapProcessor.ProcessException(fetchTrap.value());
 
         SetOpEvent(pc, privilegeLevel);
-        return;
+        return 1;
     }
 
-    // Decode
-    const auto op = m_Decoder.Decode(insn);
     if (op.opCode == OpCode::unknown)
     {
         const auto decodeTrap = MakeIllegalInstructionException(pc, insn);
 
         m_TrapProcessor.ProcessException(decodeTrap);
-        return;
+        return 1;
     }
 
     // Execute
@@ -124,26 +171,44 @@ void Processor::ProcessCycle()
     if (preExecuteTrap)
     {
         m_TrapProcessor.ProcessException(preExecuteTrap.value());
-        return;
+        return 1;
     }
 
-    if (m_Decoder.IsCompressedInstruction(insn))
+    if (m_JitEnabled && m_pBasicBlock != nullptr)
     {
-        m_Csr.SetProgramCounter(pc + 2);
-    }
-    else
-    {
-        m_Csr.SetProgramCounter(pc + 4);
+        const auto& jitRun = m_pBasicBlock->ops[m_BasicBlockIndex - 1].jitRun;
+
+        if (jitRun.function != nullptr && jitRun.opCount <= maxCycleCount)
+        {
+            return ProcessJitRun(jitRun, pc);
+        }
     }
 
-    m_Executor.ProcessOp(op, pc);
+    m_Csr.SetProgramCounter(pc + insnSize);
+
+    (m_Executor.*handler)(op, pc);
 
     auto postExecuteTrap = m_Executor.PostCheckTrap(op, pc);
     if (postExecuteTrap)
     {
         m_TrapProcessor.ProcessException(postExecuteTrap.value());
-        return;
+        return 1;
     }
+
+    m_BasicBlockContinuable = true;
+    m_WaitingForInterrupt = (op.opCode == OpCode::wfi);
+    return 1;
+}
+
+// wfi is processed as nop, so the processor waits only while no enabled interrupt is pending.
+bool Processor::IsWaitingForInterrupt() const
+{
+    return m_WaitingForInterrupt && (m_Csr.ReadInterruptPending().GetValue() & m_Csr.ReadInterruptEnable().GetValue()) == 0;
+}
+
+void Processor::SkipCycles(int cycleCount)
+{
+    m_Csr.ProcessCycles(cycleCount);
 }
 
 vaddr_t Processor::GetPc() const
@@ -211,6 +276,114 @@ bool Processor::IsTrapEventExist() const
     return m_TrapProcessor.IsTrapEventExist();
 }
 
+std::optional<Trap> Processor::FetchAndDecode(Op* pOutOp, uint32_t* pOutInsn, int* pOutInsnSize, vaddr_t pc)
+{
+    if (pc % 0x1000 == 0xffe)
+    {
+        // An op across a page boundary is not cached.
+        RAFI_RETURN_IF_TRAP(Fetch(pOutInsn, pc));
+
+        *pOutOp = m_Decoder.Decode(*pOutInsn);
+        *pOutInsnSize = m_Decoder.IsCompressedInstruction(*pOutInsn) ? 2 : 4;
+        return std::nullopt;
+    }
+
+    paddr_t paddr;
+    RAFI_RETURN_IF_TRAP(m_MemAccessUnit.Translate(&paddr, MemoryAccessType::Instruction, pc, pc));
+
+    const auto pEntry = m_DecodeCache.Find(paddr);
+    if (pEntry != nullptr)
+    {
+        // Record the same event as FetchUInt32() for dump.
+        m_MemAccessUnit.AddEvent(MemoryAccessType::Instruction, sizeof(uint32_t), pEntry->insn, pc, paddr);
+
+        *pOutOp = pEntry->op;
+        *pOutInsn = pEntry->insn;
+        *pOutInsnSize = pEntry->size;
+        return std::nullopt;
+    }
+
+    *pOutInsn = m_MemAccessUnit.FetchUInt32(pc, paddr);
+    *pOutOp = m_Decoder.Decode(*pOutInsn);
+    *pOutInsnSize = m_Decoder.IsCompressedInstruction(*pOutInsn) ? 2 : 4;
+
+    // Ops on io are not cached because Bus does not notify io writes.
+    if (m_pBus->IsMemoryAddress(paddr, sizeof(uint32_t)))
+    {
+        m_DecodeCache.Insert(paddr, *pOutOp, *pOutInsn, *pOutInsnSize);
+    }
+
+    return std::nullopt;
+}
+
+std::optional<Trap> Processor::FetchFromBasicBlock(Op* pOutOp, uint32_t* pOutInsn, int* pOutInsnSize, Executor::Handler* pOutHandler, vaddr_t pc)
+{
+    // The previous op must be completed without trap, and no block must be discarded after that.
+    const bool continuable = m_BasicBlockContinuable &&
+        m_pBasicBlock != nullptr &&
+        m_BasicBlockIndex < m_pBasicBlock->ops.size() &&
+        m_BasicBlockGeneration == m_BasicBlockCache.GetGeneration() &&
+        m_BasicBlockNextPc == pc;
+
+    m_BasicBlockContinuable = false;
+
+    paddr_t paddr;
+
+    if (continuable)
+    {
+        // Translation cannot be changed in a block, so the op is in the same physical page.
+        paddr = m_BasicBlockNextPhysicalPc;
+    }
+    else
+    {
+        m_pBasicBlock = nullptr;
+
+        if (pc % 0x1000 == 0xffe)
+        {
+            return FetchAndDecode(pOutOp, pOutInsn, pOutInsnSize, pc);
+        }
+
+        RAFI_RETURN_IF_TRAP(m_MemAccessUnit.Translate(&paddr, MemoryAccessType::Instruction, pc, pc));
+
+        m_pBasicBlock = m_BasicBlockCache.Get(paddr);
+        if (m_pBasicBlock == nullptr)
+        {
+            return FetchAndDecode(pOutOp, pOutInsn, pOutInsnSize, pc);
+        }
+
+        if (m_JitEnabled && !m_pBasicBlock->compiled && ++m_pBasicBlock->executionCount >= JitThreshold)
+        {
+            if (!m_JitCompiler.CompileBasicBlock(m_pBasicBlock))
+            {
+                // Code buffer is full. Discard all compiled code and blocks which refer to it.
+                m_JitCompiler.Reset();
+                m_BasicBlockCache.InvalidateAll();
+
+                m_pBasicBlock = m_BasicBlockCache.Get(paddr);
+            }
+        }
+
+        m_BasicBlockIndex = 0;
+        m_BasicBlockGeneration = m_BasicBlockCache.GetGeneration();
+    }
+
+    const auto& entry = m_pBasicBlock->ops[m_BasicBlockIndex];
+
+    // Record the same event as FetchUInt32() for dump.
+    m_MemAccessUnit.AddEvent(MemoryAccessType::Instruction, sizeof(uint32_t), entry.insn, pc, paddr);
+
+    *pOutOp = entry.op;
+    *pOutInsn = entry.insn;
+    *pOutInsnSize = entry.size;
+    *pOutHandler = entry.handler;
+
+    m_BasicBlockIndex++;
+    m_BasicBlockNextPc = pc + entry.size;
+    m_BasicBlockNextPhysicalPc = paddr + entry.size;
+
+    return std::nullopt;
+}
+
 std::optional<Trap> Processor::Fetch(uint32_t* pOutInsn, vaddr_t pc)
 {
     if (pc % 0x1000 == 0xffe)
@@ -247,6 +420,36 @@ std::optional<Trap> Processor::Fetch(uint32_t* pOutInsn, vaddr_t pc)
     }
 }
 
+int Processor::ProcessJitRun(const JitRun& jitRun, vaddr_t pc)
+{
+    // Compiled ops do not access memory, so the reservation can be cancelled before or after them.
+    if (jitRun.cancelReservation)
+    {
+        m_AtomicManager.Cancel();
+    }
+
+    const auto nextPc = jitRun.function(m_IntRegFile.GetRawPointer(), pc);
+
+    if (jitRun.cancelReservationIfTaken && nextPc != pc + jitRun.size)
+    {
+        m_AtomicManager.Cancel();
+    }
+
+    m_Csr.SetProgramCounter(nextPc);
+
+    // The first cycle has been counted in ProcessCycles().
+    m_Csr.ProcessCycles(jitRun.opCount - 1);
+
+    const auto firstOpSize = m_pBasicBlock->ops[m_BasicBlockIndex - 1].size;
+
+    m_BasicBlockIndex += jitRun.opCount - 1;
+    m_BasicBlockNextPc = nextPc;
+    m_BasicBlockNextPhysicalPc += jitRun.size - firstOpSize;
+    m_BasicBlockContinuable = true;
+
+    return jitRun.opCount;
+}
+
 void Processor::PrintStatus() const
 {
     printf("    OpCount: %d (0x%x)\n", m_OpCount, m_OpCount);
@@ -265,6 +468,12 @@ void Processor::SetOpEvent(vaddr_t virtualPc, PrivilegeLevel privilegeLevel)
 
 void Processor::SetOpEvent(vaddr_t virtualPc, paddr_t physicalPc, uint32_t insn, PrivilegeLevel privilegeLevel)
 {
+    if (!m_EventEnabled)
+    {
+        m_OpCount++;
+        return;
+    }
+
     m_OpEvent.opId = m_OpCount;
     m_OpEvent.insn = insn;
     m_OpEvent.privilegeLevel = privilegeLevel;
@@ -276,4 +485,33 @@ void Processor::SetOpEvent(vaddr_t virtualPc, paddr_t physicalPc, uint32_t insn,
     m_OpCount++;
 }
 
+void Processor::SaveState(SnapshotWriter* pWriter) const
+{
+    m_AtomicManager.SaveState(pWriter);
+    m_Csr.SaveState(pWriter);
+    m_FpRegFile.SaveState(pWriter);
+    m_IntRegFile.SaveState(pWriter);
+
+    pWriter->Write(m_OpCount);
+    pWriter->Write(m_WaitingForInterrupt);
+}
+
+void Processor::LoadState(SnapshotReader* pReader)
+{
+    m_AtomicManager.LoadState(pReader);
+    m_Csr.LoadState(pReader);
+    m_FpRegFile.LoadState(pReader);
+    m_IntRegFile.LoadState(pReader);
+
+    pReader->Read(&m_OpCount);
+    pReader->Read(&m_WaitingForInterrupt);
+
+    // Generations in the loaded csr are unrelated to the cached states.
+    InvalidateDecodeCache();
+    m_MemAccessUnit.FlushTlb();
+    m_InterruptController.NotifySourceChanged();
+
+    m_BasicBlockContinuable = false;
+}
+
 }}}
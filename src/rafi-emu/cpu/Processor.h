@@ -19,11 +19,14 @@
 #include <rafi/common.h>
 #include <rafi/emu.h>
 
+#include "BasicBlockCache.h"
 #include "Csr.h"
+#include "DecodeCache.h"
 #include "Executor.h"
 #include "FpRegFile.h"
 #include "InterruptController.h"
 #include "IntRegFile.h"
+#include "JitCompiler.h"
 #include "MemoryAccessUnit.h"
 #include "Trap.h"
 #include "TrapProcessor.h"
@@ -37,6 +40,11 @@ public:
     Processor(XLEN xlen, bus::Bus* pBus, vaddr_t initialPc);
 
     void SetIntReg(int regId, uint32_t regValue);
+    void SetBasicBlockEnabled(bool enabled);
+    void SetJitEnabled(bool enabled);
+
+    // Op and memory access events are recorded only while enabled. Trap events are always recorded.
+    void SetEventEnabled(bool enabled);
 
     // Interrupt source
     void RegisterExternalInterruptSource(IInterruptSource* pInterruptSource);
@@ -49,9 +57,22 @@ public:
     uint64_t ReadTime() const;
     void WriteTime(uint64_t value);
 
+    // for devices to request evaluating interrupts again
+    void NotifyInterruptSourceChanged();
+
+    // for image loading
+    void InvalidateDecodeCache();
+
     // Process
     void ProcessCycle();
 
+    // Returns processed cycle count, which is more than 1 only if a compiled run is processed.
+    int ProcessCycles(int maxCycleCount);
+
+    // for idle skip
+    bool IsWaitingForInterrupt() const;
+    void SkipCycles(int cycleCount);
+
     // for Dump
     vaddr_t GetPc() const;
     int GetCsrCount() const;
@@ -71,9 +92,17 @@ public:
 
     void PrintStatus() const;
 
+    // for snapshot
+    void SaveState(SnapshotWriter* pWriter) const;
+    void LoadState(SnapshotReader* pReader);
+
 private:
+    std::optional<Trap> FetchAndDecode(Op* pOutOp, uint32_t* pOutInsn, int* pOutInsnSize, vaddr_t pc);
+    std::optional<Trap> FetchFromBasicBlock(Op* pOutOp, uint32_t* pOutInsn, int* pOutInsnSize, Executor::Handler* pOutHandler, vaddr_t pc);
     std::optional<Trap> Fetch(uint32_t* pOutInsn, vaddr_t pc);
 
+    int ProcessJitRun(const JitRun& jitRun, vaddr_t pc);
+
     void ClearOpEvent();
 
     void SetOpEvent(vaddr_t virtualPc, PrivilegeLevel privilegeLevel);
@@ -81,21 +110,46 @@ private:
 
     const vaddr_t InvalidValue = 0xffffffffffffffff;
 
+    // Execution count of a basic block to compile it
+    static const int JitThreshold = 16;
+
+    bus::Bus* m_pBus;
+
     AtomicManager m_AtomicManager;
     Csr m_Csr;
     InterruptController m_InterruptController;
     TrapProcessor m_TrapProcessor;
 
     Decoder m_Decoder;
+    DecodeCache m_DecodeCache;
+    BasicBlockCache m_BasicBlockCache;
     FpRegFile m_FpRegFile;
     IntRegFile m_IntRegFile;
     MemoryAccessUnit m_MemAccessUnit;
+    JitCompiler m_JitCompiler;
 
     Executor m_Executor;
 
     uint32_t m_OpCount { 0 };
 
+    // for basic block execution
+    bool m_BasicBlockEnabled { false };
+    bool m_BasicBlockContinuable { false };
+
+    BasicBlock* m_pBasicBlock { nullptr };
+    size_t m_BasicBlockIndex { 0 };
+    uint64_t m_BasicBlockGeneration { 0 };
+    vaddr_t m_BasicBlockNextPc { 0 };
+    paddr_t m_BasicBlockNextPhysicalPc { 0 };
+
+    // for jit
+    bool m_JitEnabled { false };
+
+    // wfi is processed in the last cycle
+    bool m_WaitingForInterrupt { false };
+
     // for dump
+    bool m_EventEnabled { false };
     bool m_OpEventValid { false };
 
     OpEvent m_OpEvent;
@@ -0,0 +1,91 @@
+/*
+ * Copyright 2018 Akifumi Fujita
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cstring>
+
+#include <rafi/emu.h>
+
+#include "Tlb.h"
+
+namespace rafi { namespace emu { namespace cpu {
+
+Tlb::Tlb()
+{
+    Flush();
+}
+
+bool Tlb::Find(paddr_t* pOutAddr, vaddr_t addr, PrivilegeLevel privilegeLevel, MemoryAccessType accessType) const
+{
+    const auto pageNumber = addr / PageSize;
+    const auto& set = m_Entries[pageNumber % SetCount];
+
+    for (const auto& entry: set)
+    {
+        if (entry.pageNumber == pageNumber &&
+            entry.privilegeLevel == privilegeLevel &&
+            (entry.permission & GetPermissionBit(accessType)) != 0)
+        {
+            *pOutAddr = entry.physicalPageNumber * PageSize + addr % PageSize;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void Tlb::Insert(vaddr_t addr, paddr_t paddr, PrivilegeLevel privilegeLevel, MemoryAccessType accessType)
+{
+    const auto pageNumber = addr / PageSize;
+    const auto physicalPageNumber = paddr / PageSize;
+    const auto index = pageNumber % SetCount;
+
+    auto& set = m_Entries[index];
+
+    // Add permission to the existing entry, e.g. store after load.
+    for (auto& entry: set)
+    {
+        if (entry.permission != 0 &&
+            entry.pageNumber == pageNumber &&
+            entry.privilegeLevel == privilegeLevel &&
+            entry.physicalPageNumber == physicalPageNumber)
+        {
+            entry.permission |= GetPermissionBit(accessType);
+            return;
+        }
+    }
+
+    auto& entry = set[m_NextWay[index]];
+
+    entry.pageNumber = pageNumber;
+    entry.physicalPageNumber = physicalPageNumber;
+    entry.privilegeLevel = privilegeLevel;
+    entry.permission = GetPermissionBit(accessType);
+
+    m_NextWay[index] = (m_NextWay[index] + 1) % WayCount;
+}
+
+void Tlb::Flush()
+{
+    std::memset(m_Entries, 0, sizeof(m_Entries));
+    std::memset(m_NextWay, 0, sizeof(m_NextWay));
+}
+
+uint32_t Tlb::GetPermissionBit(MemoryAccessType accessType)
+{
+    return 1u << static_cast<uint32_t>(accessType);
+}
+
+}}}
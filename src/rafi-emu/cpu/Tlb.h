@@ -0,0 +1,60 @@
+/*
+ * Copyright 2018 Akifumi Fujita
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+#include <rafi/common.h>
+#include <rafi/emu.h>
+
+namespace rafi { namespace emu { namespace cpu {
+
+// Set-associative cache of 4KiB page translations.
+// An entry holds the access types which passed the page walk for the privilege level.
+// Entries are not tagged with ASID, because they are flushed when satp is written.
+class Tlb final
+{
+public:
+    Tlb();
+
+    bool Find(paddr_t* pOutAddr, vaddr_t addr, PrivilegeLevel privilegeLevel, MemoryAccessType accessType) const;
+    void Insert(vaddr_t addr, paddr_t paddr, PrivilegeLevel privilegeLevel, MemoryAccessType accessType);
+
+    void Flush();
+
+private:
+    static const int PageSize = 0x1000;
+    static const int SetCount = 64;
+    static const int WayCount = 4;
+
+    struct Entry
+    {
+        vaddr_t pageNumber;
+        paddr_t physicalPageNumber;
+        PrivilegeLevel privilegeLevel;
+        uint32_t permission; // bit mask of MemoryAccessType, 0 for invalid entry
+    };
+
+    static uint32_t GetPermissionBit(MemoryAccessType accessType);
+
+    Entry m_Entries[SetCount][WayCount];
+
+    // Round robin replacement
+    int m_NextWay[SetCount];
+};
+
+}}}
@@ -107,14 +107,16 @@ void TrapProcessor::ProcessTrapReturn(PrivilegeLevel level)
     m_TrapEvent.trapType = TrapType::Return;
     m_TrapEvent.from = m_pCsr->GetPrivilegeLevel();
     m_TrapEvent.to = nextPrivilegeLevel;
+    m_TrapEvent.trapCause = 0;
+    m_TrapEvent.trapValue = 0;
 
     m_pCsr->SetPrivilegeLevel(nextPrivilegeLevel);
 }
 void TrapProcessor::ClearEvent()
 {
+    // Trap events are recorded even if tracing is disabled, since they are used for breakpoints.
+    // The event is filled entirely when it becomes valid, so only the flag is reset here.
     m_TrapEventValid = false;
-
-    std::memset(&m_TrapEvent, 0, sizeof(m_TrapEvent));
 }
 
 void TrapProcessor::CopyTrapEvent(TrapEvent* pOut) const
@@ -66,6 +66,7 @@ void Clint::Write(const void* pBuffer, size_t size, uint64_t address)
             RAFI_EMU_ERROR("[Clint] Write size (%zd byte) for mtimecmp is invalid.\n", size);
         }
         std::memcpy(&m_TimeCmp, pBuffer, size);
+        UpdateTimerInterrupt();
         break;
     default:
         RAFI_EMU_NOT_IMPLEMENTED;
@@ -84,8 +85,11 @@ bool Clint::IsInterruptRequested() const
     return m_pProcessor->ReadTime() >= m_TimeCmp;
 }
 
-void Clint::ProcessCycle()
+void Clint::ProcessEvent()
 {
+    m_EventCycle = 0;
+
+    UpdateTimerInterrupt();
 }
 
 void Clint::RegisterProcessor(cpu::Processor* pProcessor)
@@ -93,6 +97,18 @@ void Clint::RegisterProcessor(cpu::Processor* pProcessor)
     m_pProcessor = pProcessor;
 }
 
+void Clint::RegisterScheduler(EventScheduler* pScheduler)
+{
+    m_pScheduler = pScheduler;
+}
+
+uint64_t Clint::GetTimeToInterrupt() const
+{
+    const auto time = m_pProcessor->ReadTime();
+
+    return time < m_TimeCmp ? m_TimeCmp - time : 0;
+}
+
 void Clint::ReadMsip(void* pOutBuffer, size_t size)
 {
     const auto mip = m_pProcessor->ReadInterruptPending();
@@ -146,6 +162,41 @@ void Clint::WriteTime(const void* pBuffer, size_t size)
     std::memcpy(&value, pBuffer, size);
 
     m_pProcessor->WriteTime(value);
+
+    UpdateTimerInterrupt();
+}
+
+void Clint::UpdateTimerInterrupt()
+{
+    m_pProcessor->NotifyInterruptSourceChanged();
+
+    // Time is incremented at the beginning of each cycle, so the event is needed a cycle before mtime reaches mtimecmp.
+    const auto timeToInterrupt = GetTimeToInterrupt();
+    if (timeToInterrupt <= 1)
+    {
+        return;
+    }
+
+    const auto eventCycle = m_pScheduler->GetCycle() + timeToInterrupt - 1;
+    if (m_EventCycle == 0 || eventCycle < m_EventCycle)
+    {
+        m_pScheduler->PostEvent(this, timeToInterrupt - 1);
+        m_EventCycle = eventCycle;
+    }
+}
+
+void Clint::SaveState(SnapshotWriter* pWriter) const
+{
+    pWriter->Write(m_TimeCmp);
+}
+
+// Time is loaded as a part of processor.
+void Clint::LoadState(SnapshotReader* pReader)
+{
+    pReader->Read(&m_TimeCmp);
+
+    m_EventCycle = 0;
+    UpdateTimerInterrupt();
 }
 
 }}}
@@ -22,10 +22,14 @@
 
 #include "../cpu/Processor.h"
 #include "../io/IIo.h"
+#include "../Snapshot.h"
+
+#include "EventScheduler.h"
+#include "IEventHandler.h"
 
 namespace rafi { namespace emu { namespace io {
 
-class Clint : public IIo
+class Clint : public IIo, public IEventHandler
 {
 public:
     virtual void Read(void* pOutBuffer, size_t size, uint64_t address) override;
@@ -33,9 +37,17 @@ public:
     virtual int GetSize() const override;
     virtual bool IsInterruptRequested() const override;
 
-    void ProcessCycle();
+    // Notifies processor when mtime reaches mtimecmp.
+    virtual void ProcessEvent() override;
 
     void RegisterProcessor(cpu::Processor* pProcessor);
+    void RegisterScheduler(EventScheduler* pScheduler);
+
+    void SaveState(SnapshotWriter* pWriter) const;
+    void LoadState(SnapshotReader* pReader);
+
+    // Time until mtime reaches mtimecmp (0 if it has reached)
+    uint64_t GetTimeToInterrupt() const;
 
 private:
     void ReadMsip(void* pOutBuffer, size_t size);
@@ -43,6 +55,8 @@ private:
     void WriteMsip(const void* pBuffer, size_t size);
     void WriteTime(const void* pBuffer, size_t size);
 
+    void UpdateTimerInterrupt();
+
     static const int RegisterSpaceSize = 0x10000;
 
     // Register address
@@ -51,8 +65,12 @@ private:
     static const int ADDR_MTIME = 0xbff8;
 
     cpu::Processor* m_pProcessor;
+    EventScheduler* m_pScheduler{ nullptr };
 
     uint64_t m_TimeCmp{ 0 };
+
+    // Scheduler cycle of the posted event (0 if no event is posted)
+    uint64_t m_EventCycle{ 0 };
 };
 
 }}}
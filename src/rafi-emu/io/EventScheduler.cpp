@@ -0,0 +1,75 @@
+/*
+ * Copyright 2018 Akifumi Fujita
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+
+#include <rafi/emu.h>
+
+#include "EventScheduler.h"
+
+namespace rafi { namespace emu { namespace io {
+
+int EventScheduler::GetProcessableCycle(int maxCycleCount) const
+{
+    const auto cycleToNextEvent = m_NextEventCycle - m_Cycle;
+
+    if (cycleToNextEvent < static_cast<uint64_t>(maxCycleCount))
+    {
+        return static_cast<int>(cycleToNextEvent);
+    }
+
+    return maxCycleCount;
+}
+
+void EventScheduler::PostEvent(IEventHandler* pHandler, uint64_t delay)
+{
+    if (delay == 0)
+    {
+        RAFI_EMU_ERROR("Event must be posted to future cycle.\n");
+    }
+
+    m_Events.push({ m_Cycle + delay, m_Sequence++, pHandler });
+    m_NextEventCycle = std::min(m_NextEventCycle, m_Cycle + delay);
+}
+
+void EventScheduler::SaveState(SnapshotWriter* pWriter) const
+{
+    pWriter->Write(m_Cycle);
+}
+
+void EventScheduler::LoadState(SnapshotReader* pReader)
+{
+    pReader->Read(&m_Cycle);
+
+    m_Events = decltype(m_Events)();
+    m_NextEventCycle = std::numeric_limits<uint64_t>::max();
+}
+
+void EventScheduler::DispatchEvents()
+{
+    while (!m_Events.empty() && m_Events.top().cycle <= m_Cycle)
+    {
+        const auto event = m_Events.top();
+        m_Events.pop();
+
+        // Handlers may post new events.
+        event.pHandler->ProcessEvent();
+    }
+
+    m_NextEventCycle = m_Events.empty() ? std::numeric_limits<uint64_t>::max() : m_Events.top().cycle;
+}
+
+}}}
@@ -0,0 +1,83 @@
+/*
+ * Copyright 2018 Akifumi Fujita
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <queue>
+#include <vector>
+
+#include <rafi/emu.h>
+
+#include "../Snapshot.h"
+
+#include "IEventHandler.h"
+
+namespace rafi { namespace emu { namespace io {
+
+// Devices post their future state changes here instead of being processed every cycle.
+// The processor can run without interruption until the next event.
+class EventScheduler
+{
+public:
+    uint64_t GetCycle() const
+    {
+        return m_Cycle;
+    }
+
+    // Cycles (at least 1) which can be processed before the next event.
+    int GetProcessableCycle(int maxCycleCount) const;
+
+    void PostEvent(IEventHandler* pHandler, uint64_t delay);
+
+    // Pending events are not saved. Devices post them again when their states are loaded.
+    void SaveState(SnapshotWriter* pWriter) const;
+    void LoadState(SnapshotReader* pReader);
+
+    void ProcessCycles(int cycleCount)
+    {
+        m_Cycle += cycleCount;
+
+        if (m_Cycle >= m_NextEventCycle)
+        {
+            DispatchEvents();
+        }
+    }
+
+private:
+    struct Event
+    {
+        uint64_t cycle;
+        uint64_t sequence;
+        IEventHandler* pHandler;
+
+        bool operator>(const Event& rhs) const
+        {
+            return cycle != rhs.cycle ? cycle > rhs.cycle : sequence > rhs.sequence;
+        }
+    };
+
+    void DispatchEvents();
+
+    std::priority_queue<Event, std::vector<Event>, std::greater<Event>> m_Events;
+
+    uint64_t m_Cycle{ 0 };
+    uint64_t m_NextEventCycle{ std::numeric_limits<uint64_t>::max() };
+    uint64_t m_Sequence{ 0 };
+};
+
+}}}
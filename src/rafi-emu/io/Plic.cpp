@@ -146,4 +146,24 @@ void Plic::WriteUInt32(uint64_t address, uint32_t value)
     }
 }
 
+void Plic::SaveState(SnapshotWriter* pWriter) const
+{
+    pWriter->Write(m_Priorities);
+    pWriter->Write(m_Pendings);
+    pWriter->Write(m_MachineInterruptEnables);
+    pWriter->Write(m_SupervisorInterruptEnables);
+    pWriter->Write(m_MachineThreshold);
+    pWriter->Write(m_SupervisorThreshold);
+}
+
+void Plic::LoadState(SnapshotReader* pReader)
+{
+    pReader->Read(&m_Priorities);
+    pReader->Read(&m_Pendings);
+    pReader->Read(&m_MachineInterruptEnables);
+    pReader->Read(&m_SupervisorInterruptEnables);
+    pReader->Read(&m_MachineThreshold);
+    pReader->Read(&m_SupervisorThreshold);
+}
+
 }}}
@@ -22,6 +22,7 @@
 
 #include "../cpu/Processor.h"
 #include "../io/IIo.h"
+#include "../Snapshot.h"
 
 namespace rafi { namespace emu { namespace io {
 
@@ -33,6 +34,9 @@ public:
     virtual int GetSize() const override;
     virtual bool IsInterruptRequested() const override;
 
+    void SaveState(SnapshotWriter* pWriter) const;
+    void LoadState(SnapshotReader* pReader);
+
 private:
     uint32_t ReadUInt32(uint64_t address);
     void WriteUInt32(uint64_t address, uint32_t value);
@@ -38,10 +38,10 @@ void Timer::Read(void* pOutBuffer, size_t size, uint64_t address)
     switch (address)
     {
     case Address_TimeLow:
-        value = GetLow32(m_Time);
+        value = GetLow32(GetTime());
         break;
     case Address_TimeHigh:
-        value = GetHigh32(m_Time);
+        value = GetHigh32(GetTime());
         break;
     case Address_TimeCmpLow:
         value = GetLow32(m_TimeCmp);
@@ -69,13 +69,17 @@ void Timer::Write(const void* pBuffer, size_t size, uint64_t address)
 
     std::memcpy(&value, pBuffer, sizeof(uint32_t));
 
+    auto time = GetTime();
+
     switch (address)
     {
     case Address_TimeLow:
-        SetLow32(&m_Time, value);
+        SetLow32(&time, value);
+        SetTime(time);
         break;
     case Address_TimeHigh:
-        SetHigh32(&m_Time, value);
+        SetHigh32(&time, value);
+        SetTime(time);
         break;
     case Address_TimeCmpLow:
         SetLow32(&m_TimeCmp, value);
@@ -90,12 +94,35 @@ void Timer::Write(const void* pBuffer, size_t size, uint64_t address)
 
 bool Timer::IsInterruptRequested() const
 {
-    return m_Time >= m_TimeCmp;
+    return GetTime() >= m_TimeCmp;
+}
+
+void Timer::RegisterScheduler(EventScheduler* pScheduler)
+{
+    m_pScheduler = pScheduler;
+}
+
+uint64_t Timer::GetTime() const
+{
+    return m_pScheduler->GetCycle() + m_TimeOffset;
+}
+
+void Timer::SetTime(uint64_t value)
+{
+    m_TimeOffset = value - m_pScheduler->GetCycle();
+}
+
+void Timer::SaveState(SnapshotWriter* pWriter) const
+{
+    pWriter->Write(m_TimeOffset);
+    pWriter->Write(m_TimeCmp);
 }
 
-void Timer::ProcessCycle()
+// Time is restored relative to the loaded scheduler cycle.
+void Timer::LoadState(SnapshotReader* pReader)
 {
-    m_Time++;
+    pReader->Read(&m_TimeOffset);
+    pReader->Read(&m_TimeCmp);
 }
 
 }}}
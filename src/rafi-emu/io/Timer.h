@@ -21,6 +21,9 @@
 #include <rafi/emu.h>
 
 #include "../io/IIo.h"
+#include "../Snapshot.h"
+
+#include "EventScheduler.h"
 
 namespace rafi { namespace emu { namespace io {
 
@@ -37,7 +40,10 @@ public:
 
     virtual bool IsInterruptRequested() const override;
 
-    void ProcessCycle();
+    void RegisterScheduler(EventScheduler* pScheduler);
+
+    void SaveState(SnapshotWriter* pWriter) const;
+    void LoadState(SnapshotReader* pReader);
 
 private:
     static const int RegSize = 16;
@@ -48,8 +54,14 @@ private:
     static const int Address_TimeCmpLow = 8;
     static const int Address_TimeCmpHigh = 12;
 
-    uint64_t m_Time;
-    uint64_t m_TimeCmp;
+    uint64_t GetTime() const;
+    void SetTime(uint64_t value);
+
+    EventScheduler* m_pScheduler {nullptr};
+
+    // Time is derived from cycles of scheduler. It is 1 at cycle 0 as before since io used to tick ahead of processor.
+    uint64_t m_TimeOffset {1};
+    uint64_t m_TimeCmp {0};
 };
 
 }}}
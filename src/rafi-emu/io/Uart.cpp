@@ -75,6 +75,7 @@ void Uart::Write(const void* pBuffer, size_t size, uint64_t address)
     {
     case Address_TxData:
         m_TxChars.push_back(static_cast<char>(value));
+        m_pScheduler->PostEvent(this, 1);
         break;
     case Address_RxData:
         break;
@@ -99,22 +100,27 @@ bool Uart::IsInterruptRequested() const
     return false;
 }
 
-void Uart::ProcessCycle()
+void Uart::ProcessEvent()
 {
     //UpdateRx();
     PrintTx();
+}
 
-    m_Cycle++;
+void Uart::RegisterScheduler(EventScheduler* pScheduler)
+{
+    m_pScheduler = pScheduler;
 }
 
 void Uart::UpdateRx()
 {
-    if (m_Cycle < InitialRxCycle)
+    const auto cycle = m_pScheduler->GetCycle();
+
+    if (cycle < InitialRxCycle)
     {
         return;
     }
 
-    if ((m_Cycle - InitialRxCycle) % RxCycle == 0)
+    if ((cycle - InitialRxCycle) % RxCycle == 0)
     {
         return;
     }
@@ -149,4 +155,42 @@ void Uart::PrintTx()
     m_PrintCount = m_TxChars.size();
 }
 
+void Uart::SaveState(SnapshotWriter* pWriter) const
+{
+    const uint64_t txCharCount = m_TxChars.size();
+
+    pWriter->Write(m_InterruptEnable.GetValue());
+    pWriter->Write(m_InterruptPending.GetValue());
+    pWriter->Write(txCharCount);
+    pWriter->Write(m_TxChars.data(), m_TxChars.size());
+    pWriter->Write(m_RxChar);
+    pWriter->Write(static_cast<uint64_t>(m_PrintCount));
+}
+
+void Uart::LoadState(SnapshotReader* pReader)
+{
+    uint32_t interruptEnable;
+    uint32_t interruptPending;
+    uint64_t txCharCount;
+    uint64_t printCount;
+
+    pReader->Read(&interruptEnable);
+    pReader->Read(&interruptPending);
+    pReader->Read(&txCharCount);
+
+    m_TxChars.resize(txCharCount);
+    pReader->Read(m_TxChars.data(), m_TxChars.size());
+    pReader->Read(&m_RxChar);
+    pReader->Read(&printCount);
+
+    m_InterruptEnable.SetValue(interruptEnable);
+    m_InterruptPending.SetValue(interruptPending);
+    m_PrintCount = static_cast<size_t>(printCount);
+
+    if (m_PrintCount < m_TxChars.size())
+    {
+        m_pScheduler->PostEvent(this, 1);
+    }
+}
+
 }}}
@@ -21,10 +21,14 @@
 #include <rafi/emu.h>
 
 #include "../io/IIo.h"
+#include "../Snapshot.h"
+
+#include "EventScheduler.h"
+#include "IEventHandler.h"
 
 namespace rafi { namespace emu { namespace io {
 
-class Uart : public IIo
+class Uart : public IIo, public IEventHandler
 {
 public:
     virtual void Read(void* pOutBuffer, size_t size, uint64_t address) override;
@@ -32,7 +36,13 @@ public:
     virtual int GetSize() const override;
     virtual bool IsInterruptRequested() const override;
 
-    void ProcessCycle();
+    // Written characters are output by an event on the next cycle.
+    virtual void ProcessEvent() override;
+
+    void RegisterScheduler(EventScheduler* pScheduler);
+
+    void SaveState(SnapshotWriter* pWriter) const;
+    void LoadState(SnapshotReader* pReader);
 
 private:
     struct InterruptEnable : BitField32
@@ -77,13 +87,14 @@ private:
     void UpdateRx();
     void PrintTx();
 
+    EventScheduler* m_pScheduler {nullptr};
+
     InterruptEnable m_InterruptEnable;
     InterruptPending m_InterruptPending;
 
     std::vector<char> m_TxChars;
     char m_RxChar {'\0'};
 
-    int m_Cycle {0};
     size_t m_PrintCount {0};
 };
 
@@ -90,6 +90,7 @@ void Uart16550::Write(const void* pBuffer, size_t size, uint64_t address)
         if ((m_LineControl & 0x80) == 0)
         {
             m_TxChar = value;
+            m_pScheduler->PostEvent(this, 1);
         }
         else
         {
@@ -134,11 +135,16 @@ bool Uart16550::IsInterruptRequested() const
     return false;
 }
 
-void Uart16550::ProcessCycle()
+void Uart16550::ProcessEvent()
 {
     PrintTx();
 }
 
+void Uart16550::RegisterScheduler(EventScheduler* pScheduler)
+{
+    m_pScheduler = pScheduler;
+}
+
 void Uart16550::PrintTx()
 {
     if (m_TxChar != 0)
@@ -149,4 +155,31 @@ void Uart16550::PrintTx()
     m_TxChar = 0;
 }
 
+void Uart16550::SaveState(SnapshotWriter* pWriter) const
+{
+    pWriter->Write(m_TxChar);
+    pWriter->Write(m_InterruptEnable);
+    pWriter->Write(m_InterruptIdent);
+    pWriter->Write(m_FifoControl);
+    pWriter->Write(m_LineControl);
+    pWriter->Write(m_LineStatus);
+    pWriter->Write(m_Scratch);
+}
+
+void Uart16550::LoadState(SnapshotReader* pReader)
+{
+    pReader->Read(&m_TxChar);
+    pReader->Read(&m_InterruptEnable);
+    pReader->Read(&m_InterruptIdent);
+    pReader->Read(&m_FifoControl);
+    pReader->Read(&m_LineControl);
+    pReader->Read(&m_LineStatus);
+    pReader->Read(&m_Scratch);
+
+    if (m_TxChar != 0)
+    {
+        m_pScheduler->PostEvent(this, 1);
+    }
+}
+
 }}}
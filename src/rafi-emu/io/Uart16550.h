@@ -21,6 +21,10 @@
 #include <rafi/emu.h>
 
 #include "../io/IIo.h"
+#include "../Snapshot.h"
+
+#include "EventScheduler.h"
+#include "IEventHandler.h"
 
 namespace rafi { namespace emu { namespace io {
 
@@ -31,7 +35,7 @@ namespace rafi { namespace emu { namespace io {
  *   - RX is not implemented.
  *   - TX/RX FIFO is not implemented. Characters written to data register will output to console immediately.
  */
-class Uart16550 : public IIo
+class Uart16550 : public IIo, public IEventHandler
 {
 public:
     virtual void Read(void* pOutBuffer, size_t size, uint64_t address) override;
@@ -39,7 +43,13 @@ public:
     virtual int GetSize() const override;
     virtual bool IsInterruptRequested() const override;
 
-    void ProcessCycle();
+    // Written characters are output by an event on the next cycle.
+    virtual void ProcessEvent() override;
+
+    void RegisterScheduler(EventScheduler* pScheduler);
+
+    void SaveState(SnapshotWriter* pWriter) const;
+    void LoadState(SnapshotReader* pReader);
 
 private:
     // Register address
@@ -58,6 +68,8 @@ private:
 
     void PrintTx();
 
+    EventScheduler* m_pScheduler{ nullptr };
+
     uint8_t m_TxChar{ 0x0 };
     uint8_t m_InterruptEnable{ 0x0 };
     uint8_t m_InterruptIdent{ 0x1 };
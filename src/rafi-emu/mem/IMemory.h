@@ -29,6 +29,16 @@ public:
 
     virtual void Read(void* pOutBuffer, size_t size, uint64_t address) const = 0;
     virtual void Write(const void* pBuffer, size_t size, uint64_t address) = 0;
+
+    // Host memory which holds the whole contents. nullptr if it cannot be accessed directly.
+    virtual const void* GetReadPointer() const = 0;
+    virtual void* GetWritePointer() = 0;
+
+    // Size of pages tracked by GetDirtyPageMap()
+    static const int PageShift = 12;
+
+    // Byte per page which is set to non-zero on writes. nullptr if writes are not tracked.
+    virtual uint8_t* GetDirtyPageMap() = 0;
 };
 
 }}}
@@ -14,10 +14,21 @@
  * limitations under the License.
  */
 
+#include <algorithm>
 #include <cassert>
+#include <cinttypes>
 #include <cstdint>
 #include <fstream>
 
+#ifdef WIN32
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 #include <rafi/common.h>
 #include <rafi/emu.h>
 
@@ -28,13 +39,33 @@ namespace rafi { namespace emu { namespace mem {
 Ram::Ram(size_t capacity)
     : m_Capacity(capacity)
 {
-    m_pBody = new char[capacity];
-    std::memset(m_pBody, 0, capacity);
+    // Pages are allocated and zero-filled by OS on the first access, so untouched memory uses no physical memory.
+    // On Windows the whole capacity is still charged against the commit limit.
+#ifdef WIN32
+    m_pBody = static_cast<char*>(VirtualAlloc(nullptr, capacity, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE));
+    if (m_pBody == nullptr)
+    {
+        RAFI_EMU_ERROR("Failed to allocate ram (0x%zx byte).\n", capacity);
+    }
+#else
+    void* p = mmap(nullptr, capacity, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (p == MAP_FAILED)
+    {
+        RAFI_EMU_ERROR("Failed to allocate ram (0x%zx byte).\n", capacity);
+    }
+    m_pBody = static_cast<char*>(p);
+#endif
+
+    m_DirtyPageMap.resize((capacity + (1 << PageShift) - 1) >> PageShift, 0);
 }
 
 Ram::~Ram()
 {
-    delete[] m_pBody;
+#ifdef WIN32
+    VirtualFree(m_pBody, 0, MEM_RELEASE);
+#else
+    munmap(m_pBody, m_Capacity);
+#endif
 }
 
 size_t Ram::GetCapacity() const
@@ -52,10 +83,21 @@ void Ram::LoadFile(const char* path, int offset)
     {
         RAFI_EMU_ERROR("Failed to open file: %s\n", path);
     }
-    f.read(&m_pBody[offset], m_Capacity - offset);
+
+    const size_t mappedSize = m_FileMappingEnabled ? MapFile(path, offset) : 0;
+
+    // The rest which is not mapped (a partial page at the end) is read.
+    f.seekg(mappedSize);
+    f.read(&m_pBody[offset + mappedSize], m_Capacity - offset - mappedSize);
+    MarkDirty(offset, mappedSize + static_cast<size_t>(f.gcount()));
     f.close();
 }
 
+void Ram::SetFileMappingEnabled(bool enabled)
+{
+    m_FileMappingEnabled = enabled;
+}
+
 void Ram::Copy(void* pOut, size_t size) const
 {
     assert(size == m_Capacity);
@@ -75,6 +117,175 @@ void Ram::Write(const void* pBuffer, size_t size, uint64_t address)
     assert(0 <= address && address + size <= GetCapacity());
 
     std::memcpy(&m_pBody[address], pBuffer, size);
+    MarkDirty(address, size);
+}
+
+const void* Ram::GetReadPointer() const
+{
+    return m_pBody;
+}
+
+void* Ram::GetWritePointer()
+{
+    return m_pBody;
+}
+
+uint8_t* Ram::GetDirtyPageMap()
+{
+    return m_DirtyPageMap.data();
+}
+
+size_t Ram::GetPageCount() const
+{
+    return m_DirtyPageMap.size();
+}
+
+bool Ram::IsPageDirty(size_t index) const
+{
+    return m_DirtyPageMap[index] != 0;
+}
+
+void Ram::ClearDirtyPages()
+{
+    std::fill(m_DirtyPageMap.begin(), m_DirtyPageMap.end(), 0);
+}
+
+// Incremental snapshots hold dirty pages as (index, contents) pairs.
+void Ram::SaveState(SnapshotWriter* pWriter) const
+{
+    pWriter->Write(m_Capacity);
+
+    if (pWriter->GetType() == SnapshotType::Full)
+    {
+        pWriter->Write(m_pBody, m_Capacity);
+        return;
+    }
+
+    const uint64_t dirtyPageCount = std::count_if(m_DirtyPageMap.begin(), m_DirtyPageMap.end(), [](uint8_t x) { return x != 0; });
+    pWriter->Write(dirtyPageCount);
+
+    for (size_t i = 0; i < GetPageCount(); i++)
+    {
+        if (IsPageDirty(i))
+        {
+            const uint64_t offset = static_cast<uint64_t>(i) << PageShift;
+            const auto size = std::min<size_t>(1 << PageShift, m_Capacity - offset);
+
+            pWriter->Write(static_cast<uint64_t>(i));
+            pWriter->Write(&m_pBody[offset], size);
+        }
+    }
+}
+
+void Ram::LoadState(SnapshotReader* pReader)
+{
+    size_t capacity;
+    pReader->Read(&capacity);
+
+    if (capacity != m_Capacity)
+    {
+        RAFI_EMU_ERROR("Ram size of snapshot (0x%zx byte) differs from 0x%zx byte.\n", capacity, m_Capacity);
+    }
+
+    if (pReader->GetType() == SnapshotType::Full)
+    {
+        // Pages are written only if changed to keep untouched pages unallocated.
+        char page[1 << PageShift];
+
+        for (uint64_t offset = 0; offset < m_Capacity; offset += sizeof(page))
+        {
+            const auto size = std::min<size_t>(sizeof(page), m_Capacity - offset);
+
+            pReader->Read(page, size);
+
+            if (std::memcmp(&m_pBody[offset], page, size) != 0)
+            {
+                std::memcpy(&m_pBody[offset], page, size);
+            }
+        }
+        return;
+    }
+
+    uint64_t dirtyPageCount;
+    pReader->Read(&dirtyPageCount);
+
+    for (uint64_t i = 0; i < dirtyPageCount; i++)
+    {
+        uint64_t index;
+        pReader->Read(&index);
+
+        if (index >= GetPageCount())
+        {
+            RAFI_EMU_ERROR("Page index of snapshot (0x%" PRIx64 ") is out of range.\n", index);
+        }
+
+        const uint64_t offset = index << PageShift;
+        const auto size = std::min<size_t>(1 << PageShift, m_Capacity - offset);
+
+        pReader->Read(&m_pBody[offset], size);
+    }
+}
+
+// Maps whole host pages of the file to the body copy-on-write. Returns the mapped size.
+size_t Ram::MapFile(const char* path, int offset)
+{
+#ifdef WIN32
+    static_cast<void>(path);
+    static_cast<void>(offset);
+    return 0;
+#else
+    const auto pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+
+    if (offset % pageSize != 0)
+    {
+        return 0;
+    }
+
+    const int fd = open(path, O_RDONLY);
+    if (fd < 0)
+    {
+        return 0;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0)
+    {
+        close(fd);
+        return 0;
+    }
+
+    const auto fileSize = std::min<size_t>(static_cast<size_t>(st.st_size), m_Capacity - offset);
+    const auto size = fileSize / pageSize * pageSize;
+
+    if (size > 0)
+    {
+        void* p = mmap(&m_pBody[offset], size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_FIXED, fd, 0);
+        if (p == MAP_FAILED)
+        {
+            close(fd);
+            RAFI_EMU_ERROR("Failed to map file: %s\n", path);
+        }
+    }
+
+    close(fd);
+    return size;
+#endif
+}
+
+void Ram::MarkDirty(uint64_t address, size_t size)
+{
+    if (size == 0)
+    {
+        return;
+    }
+
+    const auto first = address >> PageShift;
+    const auto last = (address + size - 1) >> PageShift;
+
+    for (auto i = first; i <= last; i++)
+    {
+        m_DirtyPageMap[i] = 1;
+    }
 }
 
 }}}
@@ -18,6 +18,9 @@
 
 #include <cstdint>
 #include <cstring>
+#include <vector>
+
+#include "../Snapshot.h"
 
 #include "IMemory.h"
 
@@ -40,12 +43,34 @@ public:
 
     virtual void LoadFile(const char* path, int offset) override;
 
+    // Files are mapped to ram copy-on-write instead of being read if possible (POSIX only).
+    void SetFileMappingEnabled(bool enabled);
+
     virtual void Read(void* pOutBuffer, size_t size, uint64_t address) const override;
     virtual void Write(const void* pBuffer, size_t size, uint64_t address) override;
 
+    virtual const void* GetReadPointer() const override;
+    virtual void* GetWritePointer() override;
+    virtual uint8_t* GetDirtyPageMap() override;
+
+    // Pages written after the last ClearDirtyPages()
+    size_t GetPageCount() const;
+    bool IsPageDirty(size_t index) const;
+    void ClearDirtyPages();
+
+    void SaveState(SnapshotWriter* pWriter) const;
+    void LoadState(SnapshotReader* pReader);
+
 private:
+    size_t MapFile(const char* path, int offset);
+    void MarkDirty(uint64_t address, size_t size);
+
     size_t m_Capacity;
 	char* m_pBody;
+
+    std::vector<uint8_t> m_DirtyPageMap;
+
+    bool m_FileMappingEnabled {false};
 };
 
 }}}
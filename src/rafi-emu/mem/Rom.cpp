@@ -71,4 +71,30 @@ void Rom::Write(const void* pBuffer, size_t size, uint64_t address)
     RAFI_EMU_ERROR("Rom does not support write operation.\n");
 }
 
+const void* Rom::GetReadPointer() const
+{
+    return m_pBody;
+}
+
+void* Rom::GetWritePointer()
+{
+    // Writes go to Write() to be reported as errors.
+    return nullptr;
+}
+
+uint8_t* Rom::GetDirtyPageMap()
+{
+    return nullptr;
+}
+
+void Rom::SaveState(SnapshotWriter* pWriter) const
+{
+    pWriter->Write(m_pBody, Capacity);
+}
+
+void Rom::LoadState(SnapshotReader* pReader)
+{
+    pReader->Read(m_pBody, Capacity);
+}
+
 }}}
@@ -19,6 +19,8 @@
 #include <cstdint>
 #include <cstring>
 
+#include "../Snapshot.h"
+
 #include "IMemory.h"
 
 namespace rafi { namespace emu { namespace mem {
@@ -41,6 +43,13 @@ public:
     virtual void Read(void* pOutBuffer, size_t size, uint64_t address) const override;
     virtual void Write(const void* pBuffer, size_t size, uint64_t address) override;
 
+    virtual const void* GetReadPointer() const override;
+    virtual void* GetWritePointer() override;
+    virtual uint8_t* GetDirtyPageMap() override;
+
+    void SaveState(SnapshotWriter* pWriter) const;
+    void LoadState(SnapshotReader* pReader);
+
 private:
     // Constants
     static const int Capacity = 4 * 1024;
@@ -0,0 +1,164 @@
+/*
+ * Copyright 2018 Akifumi Fujita
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cstdint>
+#include <vector>
+
+#pragma warning(push)
+#pragma warning(disable : 4389)
+#include <gtest/gtest.h>
+#pragma warning(pop)
+
+#include <rafi/trace.h>
+
+namespace rafi { namespace trace {
+
+namespace {
+
+// Register i changes every i + 1 cycles, so each cycle has both changed and unchanged registers.
+uint64_t GetRegValue(int cycle, int index)
+{
+    return (static_cast<uint64_t>(index) << 32) | static_cast<uint64_t>(cycle / (index + 1));
+}
+
+uint64_t GetCyclePc(int cycle)
+{
+    return 0x80000000 + cycle * 4;
+}
+
+// Writes cycles in [begin, end) as TraceLogger does. Registers are delta nodes except cycles which are multiples of keyframeInterval from begin.
+void WriteCycles(std::vector<uint8_t>* pOut, int begin, int end, int keyframeInterval)
+{
+    BinaryCycleLogger logger;
+
+    NodeIntReg64 previousIntReg;
+    NodeFpReg previousFpReg;
+
+    for (int cycle = begin; cycle < end; cycle++)
+    {
+        const auto offset = pOut->size();
+        pOut->resize(offset + BinaryCycleLogger::DefaultBufferSize);
+
+        logger.Reset(pOut->data() + offset, BinaryCycleLogger::DefaultBufferSize, cycle, XLEN::XLEN64, GetCyclePc(cycle));
+
+        NodeIntReg64 intReg;
+        NodeFpReg fpReg;
+
+        for (int i = 0; i < IntRegCount; i++)
+        {
+            intReg.regs[i] = GetRegValue(cycle, i);
+        }
+        for (int i = 0; i < FpRegCount; i++)
+        {
+            fpReg.regs[i].u64.value = ~GetRegValue(cycle, i);
+        }
+
+        if ((cycle - begin) % keyframeInterval == 0)
+        {
+            logger.Add(intReg);
+            logger.Add(fpReg);
+        }
+        else
+        {
+            logger.AddDelta(intReg, previousIntReg);
+            logger.AddDelta(fpReg, previousFpReg);
+        }
+
+        logger.Break();
+
+        previousIntReg = intReg;
+        previousFpReg = fpReg;
+
+        pOut->resize(offset + logger.GetDataSize());
+    }
+}
+
+void CheckCycles(const std::vector<uint8_t>& buffer, int begin, int end)
+{
+    TraceBinaryMemoryReader reader(buffer.data(), buffer.size());
+
+    for (int cycle = begin; cycle < end; cycle++)
+    {
+        ASSERT_FALSE(reader.IsEnd());
+
+        const auto pCycle = reader.GetCycle();
+
+        ASSERT_EQ(static_cast<uint32_t>(cycle), pCycle->GetCycle());
+        ASSERT_EQ(GetCyclePc(cycle), pCycle->GetPc());
+
+        ASSERT_TRUE(pCycle->IsIntRegExist());
+        ASSERT_TRUE(pCycle->IsFpRegExist());
+
+        for (int i = 0; i < IntRegCount; i++)
+        {
+            ASSERT_EQ(GetRegValue(cycle, i), pCycle->GetIntReg(i));
+        }
+        for (int i = 0; i < FpRegCount; i++)
+        {
+            ASSERT_EQ(~GetRegValue(cycle, i), pCycle->GetFpReg(i));
+        }
+
+        reader.Next();
+    }
+
+    ASSERT_TRUE(reader.IsEnd());
+}
+
+}
+
+TEST(DeltaTraceTest, Basic)
+{
+    std::vector<uint8_t> buffer;
+    WriteCycles(&buffer, 0, 100, 100);
+
+    CheckCycles(buffer, 0, 100);
+}
+
+// Old traces and the first cycle of each segment have full register nodes between delta nodes.
+TEST(DeltaTraceTest, Keyframe)
+{
+    std::vector<uint8_t> buffer;
+    WriteCycles(&buffer, 0, 100, 16);
+
+    CheckCycles(buffer, 0, 100);
+}
+
+// Each segment is read by its own reader, so the first cycle of it must not depend on the previous segment.
+TEST(DeltaTraceTest, SegmentStart)
+{
+    std::vector<uint8_t> segment0;
+    std::vector<uint8_t> segment1;
+    WriteCycles(&segment0, 0, 50, 50);
+    WriteCycles(&segment1, 50, 100, 50);
+
+    CheckCycles(segment1, 50, 100);
+    CheckCycles(segment0, 0, 50);
+}
+
+TEST(DeltaTraceTest, DeltaWithoutKeyframe)
+{
+    std::vector<uint8_t> keyframe;
+    std::vector<uint8_t> buffer;
+    WriteCycles(&keyframe, 0, 1, 10);
+    WriteCycles(&buffer, 0, 10, 10);
+
+    // Drop the keyframe so that the first cycle has only delta nodes.
+    const std::vector<uint8_t> deltas(buffer.begin() + keyframe.size(), buffer.end());
+
+    EXPECT_THROW(TraceBinaryMemoryReader(deltas.data(), deltas.size()), TraceException);
+}
+
+}}
@@ -0,0 +1,171 @@
+/*
+ * Copyright 2018 Akifumi Fujita
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#pragma warning(push)
+#pragma warning(disable : 4389)
+#include <gtest/gtest.h>
+#pragma warning(pop)
+
+#include <rafi/emu.h>
+
+#include "../../src/rafi-emu/Farm.h"
+
+using namespace rafi::emu;
+
+namespace rafi { namespace test {
+
+namespace {
+
+const vaddr_t ProgramAddress = 0x80000000;
+const paddr_t HostIoAddress = 0x80001000;
+const size_t RamSize = 64 * 1024;
+
+// lui, addi, (addi, bne) * loopCount, lui, addi, sw
+int GetExpectedCycle(int loopCount)
+{
+    return 2 + loopCount * 2 + 3;
+}
+
+// Writes an RV32 image which decrements a counter loopCount times and then writes value to host io.
+std::string MakeImage(const char* name, int loopCount, uint32_t value)
+{
+    const uint32_t hi = static_cast<uint32_t>(loopCount) >> 12;
+    const uint32_t lo = static_cast<uint32_t>(loopCount) & 0x7ff;
+
+    const uint32_t program[] =
+    {
+        (hi << 12) | (5 << 7) | 0x37,                   // lui x5, hi
+        (lo << 20) | (5 << 15) | (5 << 7) | 0x13,       // addi x5, x5, lo
+        (0xfffu << 20) | (5 << 15) | (5 << 7) | 0x13,   // addi x5, x5, -1
+        0xfe029ee3,                                     // bne x5, x0, -4
+        (HostIoAddress & 0xfffff000) | (6 << 7) | 0x37, // lui x6, HostIoAddress
+        (value << 20) | (7 << 7) | 0x13,                // addi x7, x0, value
+        (7 << 20) | (6 << 15) | (2 << 12) | 0x23,       // sw x7, 0(x6)
+        0x0000006f,                                     // jal x0, 0
+    };
+
+    const auto path = std::string("FarmTest.") + name + ".bin";
+
+    auto fp = std::fopen(path.c_str(), "wb");
+    EXPECT_NE(nullptr, fp);
+
+    std::fwrite(program, sizeof(program), 1, fp);
+    std::fclose(fp);
+
+    return path;
+}
+
+FarmJob MakeJob(const std::string& path)
+{
+    FarmJob job;
+
+    job.xlen = XLEN::XLEN32;
+    job.pc = ProgramAddress;
+    job.ramSize = RamSize;
+    job.images.push_back(FarmImage{ path, ProgramAddress });
+    job.condition = EmulationStop_HostIo;
+    job.hostIoAddress = HostIoAddress;
+    job.cycle = 10 * 1000 * 1000;
+    job.basicBlockEnabled = false;
+    job.jitEnabled = false;
+
+    return job;
+}
+
+}
+
+TEST(FarmTest, UnevenJobs)
+{
+    const int JobCount = 16;
+
+    // Jobs are distributed in round robin, so the first thread gets all long jobs and the others have to steal them.
+    const int LongLoopCount = 0x10000 + 3;
+    const int ShortLoopCount = 5;
+
+    const auto longPath = MakeImage("long", LongLoopCount, 1);
+    const auto shortPath = MakeImage("short", ShortLoopCount, 3);
+
+    std::vector<FarmJob> jobs;
+
+    for (int i = 0; i < JobCount; i++)
+    {
+        jobs.push_back(MakeJob(i % 4 == 0 ? longPath : shortPath));
+    }
+
+    Farm farm(4);
+    const auto results = farm.Run(jobs);
+
+    ASSERT_EQ(static_cast<size_t>(JobCount), results.size());
+
+    for (int i = 0; i < JobCount; i++)
+    {
+        const bool isLong = i % 4 == 0;
+
+        EXPECT_TRUE(results[i].completed) << "job " << i;
+        EXPECT_EQ(GetExpectedCycle(isLong ? LongLoopCount : ShortLoopCount), results[i].cycle) << "job " << i;
+        EXPECT_EQ(isLong ? 1u : 3u, results[i].hostIoValue) << "job " << i;
+    }
+
+    std::remove(longPath.c_str());
+    std::remove(shortPath.c_str());
+}
+
+TEST(FarmTest, FailedJob)
+{
+    const auto path = MakeImage("failed", 1, 1);
+
+    std::vector<FarmJob> jobs;
+
+    jobs.push_back(MakeJob(path));
+    jobs.push_back(MakeJob("FarmTest.missing.bin"));
+    jobs.push_back(MakeJob(path));
+
+    Farm farm(2);
+    const auto results = farm.Run(jobs);
+
+    ASSERT_EQ(3u, results.size());
+
+    EXPECT_TRUE(results[0].completed);
+    EXPECT_FALSE(results[1].completed);
+    EXPECT_TRUE(results[2].completed);
+
+    std::remove(path.c_str());
+}
+
+TEST(FarmTest, HostIoDisabled)
+{
+    const auto path = MakeImage("nohostio", 1, 1);
+
+    auto job = MakeJob(path);
+    job.condition = EmulationStop_None;
+    job.cycle = 100;
+
+    const auto result = Farm::RunJob(job);
+
+    // Runs until the cycle budget runs out since the write to host io does not stop emulation.
+    EXPECT_TRUE(result.completed);
+    EXPECT_EQ(100, result.cycle);
+    EXPECT_EQ(0u, result.hostIoValue);
+
+    std::remove(path.c_str());
+}
+
+}}
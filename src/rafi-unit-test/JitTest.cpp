@@ -0,0 +1,245 @@
+/*
+ * Copyright 2018 Akifumi Fujita
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#pragma warning(push)
+#pragma warning(disable : 4389)
+#include <gtest/gtest.h>
+#pragma warning(pop)
+
+#include <rafi/emu.h>
+#include <rafi/trace.h>
+
+#include "../../src/rafi-emu/cpu/JitCompiler.h"
+#include "../../src/rafi-emu/System.h"
+
+using namespace rafi::emu;
+
+namespace rafi { namespace test {
+
+namespace {
+
+const vaddr_t ProgramAddress = 0x80000000;
+const size_t RamSize = 64 * 1024;
+const int LoopCount = 200;
+const int CycleCount = 20000;
+const int ChunkCycleCount = 1000;
+
+const uint32_t OpcodeOp = 0x33;
+const uint32_t OpcodeOpImm = 0x13;
+const uint32_t OpcodeOp32 = 0x3b;
+const uint32_t OpcodeOpImm32 = 0x1b;
+const uint32_t OpcodeLui = 0x37;
+const uint32_t OpcodeAuipc = 0x17;
+const uint32_t OpcodeJal = 0x6f;
+const uint32_t OpcodeBranch = 0x63;
+
+uint32_t EncodeR(uint32_t opcode, uint32_t funct3, uint32_t funct7, int rd, int rs1, int rs2)
+{
+    return (funct7 << 25) | (rs2 << 20) | (rs1 << 15) | (funct3 << 12) | (rd << 7) | opcode;
+}
+
+uint32_t EncodeI(uint32_t opcode, uint32_t funct3, int rd, int rs1, int32_t imm)
+{
+    return ((static_cast<uint32_t>(imm) & 0xfff) << 20) | (rs1 << 15) | (funct3 << 12) | (rd << 7) | opcode;
+}
+
+uint32_t EncodeU(uint32_t opcode, int rd, uint32_t imm)
+{
+    return (imm << 12) | (rd << 7) | opcode;
+}
+
+uint32_t EncodeB(uint32_t funct3, int rs1, int rs2, int32_t offset)
+{
+    const auto imm = static_cast<uint32_t>(offset);
+
+    return (((imm >> 12) & 0x1) << 31) | (((imm >> 5) & 0x3f) << 25) | (rs2 << 20) | (rs1 << 15) |
+        (funct3 << 12) | (((imm >> 1) & 0xf) << 8) | (((imm >> 11) & 0x1) << 7) | OpcodeBranch;
+}
+
+uint32_t EncodeJ(int rd, int32_t offset)
+{
+    const auto imm = static_cast<uint32_t>(offset);
+
+    return (((imm >> 20) & 0x1) << 31) | (((imm >> 1) & 0x3ff) << 21) | (((imm >> 11) & 0x1) << 20) |
+        (((imm >> 12) & 0xff) << 12) | (rd << 7) | OpcodeJal;
+}
+
+// Builds a loop that executes every op JitCompiler can translate, feeding results back to the sources.
+std::vector<uint32_t> MakeProgram(XLEN xlen)
+{
+    std::vector<uint32_t> program;
+
+    // Seed registers (lui, addi)
+    program.push_back(EncodeU(OpcodeLui, 1, 0x12345));
+    program.push_back(EncodeI(OpcodeOpImm, 0, 1, 1, 0x678));
+    program.push_back(EncodeU(OpcodeLui, 2, 0x87654));
+    program.push_back(EncodeI(OpcodeOpImm, 0, 2, 2, 0x321));
+    program.push_back(EncodeU(OpcodeLui, 3, 0xfffff));
+    program.push_back(EncodeI(OpcodeOpImm, 0, 3, 3, -5));
+    program.push_back(EncodeI(OpcodeOpImm, 0, 4, 0, 7));
+    program.push_back(EncodeI(OpcodeOpImm, 0, 31, 0, LoopCount));
+
+    const auto loopHead = static_cast<int32_t>(program.size());
+
+    // ALU and shift (register)
+    program.push_back(EncodeR(OpcodeOp, 0, 0x00, 5, 1, 2));   // add
+    program.push_back(EncodeR(OpcodeOp, 0, 0x20, 6, 5, 3));   // sub
+    program.push_back(EncodeR(OpcodeOp, 1, 0x00, 7, 1, 4));   // sll
+    program.push_back(EncodeR(OpcodeOp, 5, 0x00, 8, 2, 4));   // srl
+    program.push_back(EncodeR(OpcodeOp, 5, 0x20, 9, 3, 4));   // sra
+    program.push_back(EncodeR(OpcodeOp, 2, 0x00, 10, 2, 1));  // slt
+    program.push_back(EncodeR(OpcodeOp, 3, 0x00, 11, 2, 1));  // sltu
+    program.push_back(EncodeR(OpcodeOp, 4, 0x00, 12, 5, 6));  // xor
+    program.push_back(EncodeR(OpcodeOp, 6, 0x00, 13, 7, 8));  // or
+    program.push_back(EncodeR(OpcodeOp, 7, 0x00, 14, 9, 12)); // and
+
+    // ALU and shift (immediate)
+    program.push_back(EncodeI(OpcodeOpImm, 0, 15, 1, -123));   // addi
+    program.push_back(EncodeI(OpcodeOpImm, 2, 16, 3, -4));     // slti
+    program.push_back(EncodeI(OpcodeOpImm, 3, 17, 3, 5));      // sltiu
+    program.push_back(EncodeI(OpcodeOpImm, 4, 18, 5, 0x555));  // xori
+    program.push_back(EncodeI(OpcodeOpImm, 6, 19, 6, -0x100)); // ori
+    program.push_back(EncodeI(OpcodeOpImm, 7, 20, 7, 0x7ff));  // andi
+    program.push_back(EncodeI(OpcodeOpImm, 1, 21, 8, 3));      // slli
+    program.push_back(EncodeI(OpcodeOpImm, 5, 22, 9, 5));      // srli
+    program.push_back(EncodeI(OpcodeOpImm, 5, 23, 3, 0x402));  // srai
+
+    // M extension
+    program.push_back(EncodeR(OpcodeOp, 0, 0x01, 24, 1, 2)); // mul
+    program.push_back(EncodeR(OpcodeOp, 1, 0x01, 25, 2, 3)); // mulh
+    program.push_back(EncodeR(OpcodeOp, 2, 0x01, 26, 3, 2)); // mulhsu
+    program.push_back(EncodeR(OpcodeOp, 3, 0x01, 27, 2, 3)); // mulhu
+
+    program.push_back(EncodeU(OpcodeAuipc, 28, 0x1));
+
+    if (xlen == XLEN::XLEN64)
+    {
+        program.push_back(EncodeI(OpcodeOpImm, 1, 21, 21, 33));         // slli (shamt >= 32)
+        program.push_back(EncodeI(OpcodeOpImm, 5, 22, 22, 0x400 | 35));  // srai (shamt >= 32)
+        program.push_back(EncodeR(OpcodeOp32, 0, 0x00, 29, 1, 2));      // addw
+        program.push_back(EncodeR(OpcodeOp32, 0, 0x20, 30, 29, 3));      // subw
+        program.push_back(EncodeR(OpcodeOp32, 1, 0x00, 29, 30, 4));     // sllw
+        program.push_back(EncodeR(OpcodeOp32, 5, 0x00, 30, 2, 4));      // srlw
+        program.push_back(EncodeR(OpcodeOp32, 5, 0x20, 29, 3, 4));      // sraw
+        program.push_back(EncodeR(OpcodeOp32, 0, 0x01, 30, 29, 1));     // mulw
+        program.push_back(EncodeI(OpcodeOpImm32, 0, 29, 30, -777));      // addiw
+        program.push_back(EncodeI(OpcodeOpImm32, 1, 30, 29, 13));        // slliw
+        program.push_back(EncodeI(OpcodeOpImm32, 5, 29, 30, 7));         // srliw
+        program.push_back(EncodeI(OpcodeOpImm32, 5, 30, 2, 0x400 | 9));  // sraiw
+        program.push_back(EncodeR(OpcodeOp, 4, 0x00, 2, 2, 30));         // xor
+    }
+
+    // Write to x0 must be discarded
+    program.push_back(EncodeR(OpcodeOp, 0, 0x00, 0, 1, 2));
+
+    // Branches, each skipping one increment
+    program.push_back(EncodeB(0, 10, 11, 8)); // beq
+    program.push_back(EncodeI(OpcodeOpImm, 0, 15, 15, 1));
+    program.push_back(EncodeB(1, 10, 11, 8)); // bne
+    program.push_back(EncodeI(OpcodeOpImm, 0, 16, 16, 1));
+    program.push_back(EncodeB(4, 2, 1, 8));   // blt
+    program.push_back(EncodeI(OpcodeOpImm, 0, 17, 17, 1));
+    program.push_back(EncodeB(5, 2, 1, 8));   // bge
+    program.push_back(EncodeI(OpcodeOpImm, 0, 18, 18, 1));
+    program.push_back(EncodeB(6, 2, 1, 8));   // bltu
+    program.push_back(EncodeI(OpcodeOpImm, 0, 19, 19, 1));
+    program.push_back(EncodeB(7, 2, 1, 8));   // bgeu
+    program.push_back(EncodeI(OpcodeOpImm, 0, 20, 20, 1));
+    program.push_back(EncodeJ(19, 8));        // jal
+    program.push_back(EncodeI(OpcodeOpImm, 0, 21, 21, 1));
+
+    // Feedback
+    program.push_back(EncodeR(OpcodeOp, 0, 0x00, 1, 1, 12));  // add
+    program.push_back(EncodeR(OpcodeOp, 4, 0x00, 2, 2, 24));  // xor
+    program.push_back(EncodeR(OpcodeOp, 0, 0x00, 2, 2, 15));  // add
+    program.push_back(EncodeR(OpcodeOp, 0, 0x20, 3, 3, 25));  // sub
+    program.push_back(EncodeI(OpcodeOpImm, 4, 3, 3, -0x2a5)); // xori
+    program.push_back(EncodeI(OpcodeOpImm, 0, 4, 4, 3));      // addi
+    program.push_back(EncodeI(OpcodeOpImm, 7, 4, 4, 31));     // andi
+
+    program.push_back(EncodeI(OpcodeOpImm, 0, 31, 31, -1));
+    program.push_back(EncodeB(1, 31, 0, (loopHead - static_cast<int32_t>(program.size())) * 4)); // bne
+
+    program.push_back(EncodeJ(0, 0));
+
+    return program;
+}
+
+template <typename NodeIntReg>
+void CompareWithInterpreter(XLEN xlen)
+{
+    if (!cpu::JitCompiler::IsHostSupported())
+    {
+        return;
+    }
+
+    const auto program = MakeProgram(xlen);
+
+    auto pInterpreter = std::make_unique<System>(xlen, ProgramAddress, RamSize);
+    auto pJit = std::make_unique<System>(xlen, ProgramAddress, RamSize);
+
+    pJit->SetBasicBlockEnabled(true);
+    pJit->SetJitEnabled(true);
+
+    pInterpreter->WriteMemory(program.data(), program.size() * sizeof(uint32_t), ProgramAddress);
+    pJit->WriteMemory(program.data(), program.size() * sizeof(uint32_t), ProgramAddress);
+
+    for (int cycle = 0; cycle < CycleCount; cycle += ChunkCycleCount)
+    {
+        for (int done = 0; done < ChunkCycleCount; )
+        {
+            done += pInterpreter->ProcessCycles(ChunkCycleCount - done);
+        }
+        for (int done = 0; done < ChunkCycleCount; )
+        {
+            done += pJit->ProcessCycles(ChunkCycleCount - done);
+        }
+
+        NodeIntReg expected;
+        NodeIntReg actual;
+
+        pInterpreter->CopyIntReg(&expected);
+        pJit->CopyIntReg(&actual);
+
+        ASSERT_EQ(pInterpreter->GetPc(), pJit->GetPc()) << "cycle " << cycle;
+
+        for (int i = 0; i < 32; i++)
+        {
+            ASSERT_EQ(expected.regs[i], actual.regs[i]) << "x" << i << " at cycle " << cycle;
+        }
+    }
+
+    // The loop must have finished in the terminating jal
+    ASSERT_EQ(ProgramAddress + (program.size() - 1) * sizeof(uint32_t), pJit->GetPc());
+}
+
+}
+
+TEST(JitTest, RV32)
+{
+    CompareWithInterpreter<trace::NodeIntReg32>(XLEN::XLEN32);
+}
+
+TEST(JitTest, RV64)
+{
+    CompareWithInterpreter<trace::NodeIntReg64>(XLEN::XLEN64);
+}
+
+}}
@@ -0,0 +1,178 @@
+/*
+ * Copyright 2018 Akifumi Fujita
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#pragma warning(push)
+#pragma warning(disable : 4389)
+#include <gtest/gtest.h>
+#pragma warning(pop)
+
+#include <rafi/trace.h>
+
+#include "../../src/librafi_trace/LzCodec.h"
+
+namespace rafi { namespace trace {
+
+namespace {
+
+std::vector<uint8_t> Compress(const std::vector<uint8_t>& input)
+{
+    // Compressor is too large for stack.
+    auto pCompressor = std::make_unique<LzCompressor>();
+
+    // Incompressible input grows by 1 byte per 255 bytes of literals in addition to a token.
+    std::vector<uint8_t> output(input.size() + input.size() / 255 + 16);
+
+    const auto size = pCompressor->Compress(output.data(), output.size(), input.data(), input.size());
+    EXPECT_NE(0u, size);
+
+    output.resize(size);
+    return output;
+}
+
+void CheckRoundTrip(const std::vector<uint8_t>& input)
+{
+    const auto compressed = Compress(input);
+
+    std::vector<uint8_t> output(input.size());
+    LzDecompress(output.data(), output.size(), compressed.data(), compressed.size());
+
+    ASSERT_EQ(input, output);
+}
+
+// Repeats a pattern of patternSize bytes.
+std::vector<uint8_t> MakeRepeatedInput(size_t size, size_t patternSize)
+{
+    std::vector<uint8_t> input(size);
+
+    for (size_t i = 0; i < size; i++)
+    {
+        input[i] = static_cast<uint8_t>((i % patternSize) * 37 + 1);
+    }
+
+    return input;
+}
+
+std::vector<uint8_t> MakeRandomInput(size_t size)
+{
+    std::vector<uint8_t> input(size);
+    uint32_t x = 2463534242u;
+
+    for (size_t i = 0; i < size; i++)
+    {
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        input[i] = static_cast<uint8_t>(x);
+    }
+
+    return input;
+}
+
+}
+
+TEST(LzCodecTest, Empty)
+{
+    CheckRoundTrip(std::vector<uint8_t>());
+}
+
+// Input shorter than 13 bytes is stored as literals only.
+TEST(LzCodecTest, Short)
+{
+    for (size_t size = 1; size < 16; size++)
+    {
+        CheckRoundTrip(MakeRepeatedInput(size, 1));
+    }
+}
+
+TEST(LzCodecTest, Incompressible)
+{
+    const auto input = MakeRandomInput(4096);
+
+    CheckRoundTrip(input);
+    ASSERT_GT(Compress(input).size(), input.size());
+}
+
+// Matches with offset smaller than the length copy bytes written by themselves.
+TEST(LzCodecTest, OverlappedMatch)
+{
+    for (size_t patternSize = 1; patternSize <= 8; patternSize++)
+    {
+        const auto input = MakeRepeatedInput(1000, patternSize);
+
+        CheckRoundTrip(input);
+        ASSERT_LT(Compress(input).size(), 32u);
+    }
+}
+
+// Lengths of 15 or more are followed by extra bytes in 255 unit.
+TEST(LzCodecTest, LongLength)
+{
+    for (size_t size: { 15 + 255 - 1, 15 + 255, 15 + 255 + 1, 15 + 255 * 3, 100000 })
+    {
+        auto literals = MakeRandomInput(size);
+        CheckRoundTrip(literals);
+
+        const auto match = MakeRepeatedInput(size + 10, 3);
+        CheckRoundTrip(match);
+
+        // Long literals followed by a long match
+        literals.insert(literals.end(), match.begin(), match.end());
+        CheckRoundTrip(literals);
+    }
+}
+
+TEST(LzCodecTest, Truncated)
+{
+    const auto input = MakeRepeatedInput(1000, 7);
+    const auto compressed = Compress(input);
+
+    std::vector<uint8_t> output(input.size());
+
+    for (size_t size = 0; size < compressed.size(); size++)
+    {
+        EXPECT_THROW(LzDecompress(output.data(), output.size(), compressed.data(), size), TraceException);
+    }
+}
+
+TEST(LzCodecTest, SizeMismatch)
+{
+    const auto input = MakeRepeatedInput(1000, 7);
+    const auto compressed = Compress(input);
+
+    std::vector<uint8_t> output(input.size() + 1);
+
+    EXPECT_THROW(LzDecompress(output.data(), input.size() - 1, compressed.data(), compressed.size()), TraceException);
+    EXPECT_THROW(LzDecompress(output.data(), input.size() + 1, compressed.data(), compressed.size()), TraceException);
+}
+
+TEST(LzCodecTest, BrokenOffset)
+{
+    std::vector<uint8_t> output(64);
+
+    // Offset 0
+    const uint8_t zeroOffset[] = { 0x10, 0xaa, 0x00, 0x00, 0x00 };
+    EXPECT_THROW(LzDecompress(output.data(), 5, zeroOffset, sizeof(zeroOffset)), TraceException);
+
+    // Offset before the beginning of output
+    const uint8_t farOffset[] = { 0x10, 0xaa, 0x02, 0x00, 0x00 };
+    EXPECT_THROW(LzDecompress(output.data(), 5, farOffset, sizeof(farOffset)), TraceException);
+}
+
+}}
@@ -83,6 +83,10 @@ def MakeEmulatorCommand(config):
         cmd.append("--enable-dump-memory")
     if config['gdb'] != 0:
         cmd.extend(["--gdb", config['gdb']])
+    if config['load_snapshot'] is not None:
+        cmd.extend(["--load-snapshot", config['load_snapshot']])
+    if config['save_snapshot'] is not None:
+        cmd.extend(["--save-snapshot", config['save_snapshot']])
     return cmd
 
 def RunEmulator(config):
@@ -105,6 +109,8 @@ if __name__ == '__main__':
     parser.add_option("--enable-dump-int-reg", dest="enable_dump_int_reg", action="store_true", default=False, help="Enable integer register dump.")
     parser.add_option("--enable-dump-memory", dest="enable_dump_memory", action="store_true", default=False, help="Enable memory dump.")
     parser.add_option("--gdb", dest="gdb", default=0, help="Run rafi-dump after emulation.")
+    parser.add_option("--load-snapshot", dest="load_snapshot", default=None, help="Start emulation from the specified snapshot.")
+    parser.add_option("--save-snapshot", dest="save_snapshot", default=None, help="Save snapshot at the specified cycle (<path>@<cycle>).")
 
     (options, args) = parser.parse_args()
 
@@ -120,6 +126,8 @@ if __name__ == '__main__':
         'enable_dump_int_reg': options.enable_dump_int_reg,
         'enable_dump_memory': options.enable_dump_memory,
         'gdb': options.gdb,
+        'load_snapshot': options.load_snapshot,
+        'save_snapshot': options.save_snapshot,
     }
     result = RunEmulator(config)
     if result != 0:
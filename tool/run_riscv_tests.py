@@ -24,6 +24,7 @@ from operator import or_
 
 BinaryDirPath = "./third_party/rafi-prebuilt-binary/riscv-tests/isa"
 TraceDirPath = "./work/riscv-tests/trace"
+SnapshotDirPath = "./work/riscv-tests/snapshot"
 Timeout = 30
 
 #
@@ -54,8 +55,8 @@ def GetEmulatorPath(build_type):
 
 def InitializeDirectory(path):
     os.makedirs(path, exist_ok=True)
-    for filename in os.listdir(f"{TraceDirPath}"):
-        os.remove(f"{TraceDirPath}/{filename}")
+    for filename in os.listdir(f"{path}"):
+        os.remove(f"{path}/{filename}")
 
 def PrintCommand(msg, cmd):
     print(f"{msg} {cmd[0]}")
@@ -75,26 +76,49 @@ def VerifyTraces(paths, build_type):
 def RunEmulator(config):
     binary_path = f"{BinaryDirPath}/{config['name']}.bin"
     trace_path = f"{TraceDirPath}/{config['name']}"
+    snapshot_path = f"{SnapshotDirPath}/{config['name']}.snap"
     cmd = [
         GetEmulatorPath(config['build_type']),
-        "--cycle", str(config['cycle']),
-        "--load", f"{binary_path}:0x80000000",
-        "--enable-dump-fp-reg",
-        "--dump-path", trace_path,
         "--pc", "0x80000000",
         "--host-io-addr", str(config['host-io-addr']),
         "--xlen", str(config['xlen']),
     ]
 
+    # The first process saves a snapshot and the second one restores it, so that the snapshot is checked across processes.
+    snapshot_cycle = config['snapshot_cycle']
+    if snapshot_cycle is not None:
+        save_cmd = cmd + [
+            "--cycle", str(snapshot_cycle + 1),
+            "--load", f"{binary_path}:0x80000000",
+            "--save-snapshot", f"{snapshot_path}@{snapshot_cycle}",
+        ]
+
+        PrintCommand("Run", save_cmd)
+
+        result = subprocess.run(save_cmd)
+        if result.returncode != 0:
+            return False # Emulation Failure
+
+        cmd += ["--load-snapshot", snapshot_path]
+    else:
+        cmd += ["--load", f"{binary_path}:0x80000000"]
+
+    cmd += [
+        "--cycle", str(config['cycle']),
+        "--enable-dump-fp-reg",
+        "--dump-path", trace_path,
+    ]
+
     PrintCommand("Run", cmd)
 
     result = subprocess.run(cmd)
     if result.returncode != 0:
         return False # Emulation Failure
 
-def RunTests(configs, build_type):
+def RunTests(configs, build_type, snapshot_cycle):
     for config in configs:
         config['build_type'] = build_type
+        config['snapshot_cycle'] = snapshot_cycle
 
     with multiprocessing.Pool(multiprocessing.cpu_count()) as p:
         # use map_async() to avoid problem with Ctrl-C
@@ -115,6 +139,7 @@ if __name__ == '__main__':
     parser.add_option("-f", dest="filter", default="*", help="Filter test by name.")
     parser.add_option("-i", dest="input_path", default=None, help="Input test list json path.")
     parser.add_option("-l", dest="list_tests", action="store_true", default=False, help="List test names.")
+    parser.add_option("-s", dest="snapshot_cycle", type="int", default=None, help="Restart each test from a snapshot saved at the cycle by another process.")
 
     (options, args) = parser.parse_args()
 
@@ -135,8 +160,12 @@ if __name__ == '__main__':
     print(f"Initialize trace directory ({TraceDirPath})")
     InitializeDirectory(TraceDirPath)
 
+    if options.snapshot_cycle is not None:
+        print(f"Initialize snapshot directory ({SnapshotDirPath})")
+        InitializeDirectory(SnapshotDirPath)
+
     print("Run test on emulator:")
-    exit_code = RunTests(runnable, build_type)
+    exit_code = RunTests(runnable, build_type, options.snapshot_cycle)
 
     if len(skipped) > 0:
         print("Skipped tests:")